@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+namespace bench {
+
+    // Wall-clock milliseconds since construction (or the last reset)
+    class Timer {
+    public:
+        Timer() : start_(std::chrono::steady_clock::now()) {}
+
+        void reset() { start_ = std::chrono::steady_clock::now(); }
+
+        double ms() const {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Keeps results alive so the optimizer can't drop the measured work
+    inline volatile uint64_t sink = 0;
+
+    inline void consume(uint64_t value) { sink = sink + value; }
+
+    // First command-line argument as a count, or the default
+    inline size_t countArg(int argc, char** argv, size_t fallback) {
+        if (argc < 2) return fallback;
+        long long value = std::atoll(argv[1]);
+        return value > 0 ? static_cast<size_t>(value) : fallback;
+    }
+
+    inline void header(const char* title, size_t count) {
+        std::printf("\n%s (%zu)\n", title, count);
+    }
+
+    inline void row(const char* name, double ms) {
+        std::printf("    %-36s %9.1f ms\n", name, ms);
+    }
+
+} // namespace bench
@@ -0,0 +1,197 @@
+// ECS microbenchmarks. Usage: EcsBench [entityCount]  (default 1M)
+//
+// Timings are wall-clock for one pass over every entity. They're meant
+// for comparing one change against the next on the same machine, not as
+// absolute numbers.
+
+#include "BenchUtil.h"
+
+#include "world/World.h"
+#include "world/ComponentStorage.h"
+#include "world/Types.h"
+#include "components/CoreComponents.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace libre;
+
+namespace {
+
+    // 48 bytes, the size of a world transform
+    struct Payload48 {
+        float values[12] = {};
+    };
+    static_assert(sizeof(Payload48) == 48, "Payload48 must stay 48 bytes");
+
+    std::vector<EntityID> makeEntityIDs(size_t count) {
+        std::vector<EntityID> ids(count);
+        for (size_t i = 0; i < count; ++i) {
+            ids[i] = makeEntityID(static_cast<uint32_t>(i + 1), 1);
+        }
+        return ids;
+    }
+
+    std::vector<EntityID> shuffled(std::vector<EntityID> ids, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::shuffle(ids.begin(), ids.end(), rng);
+        return ids;
+    }
+
+    // ========================================================================
+    // STORAGE - add/get/has/remove on one ComponentStorage, shuffled order
+    // ========================================================================
+
+    void benchStorage(size_t count) {
+        bench::header("ComponentStorage<48 B>, shuffled access", count);
+
+        std::vector<EntityID> ids = makeEntityIDs(count);
+        std::vector<EntityID> addOrder = shuffled(ids, 1);
+        std::vector<EntityID> accessOrder = shuffled(ids, 2);
+        std::vector<EntityID> removeOrder = shuffled(ids, 3);
+
+        ComponentStorage<Payload48> storage;
+        bench::Timer timer;
+
+        Payload48 payload;
+        for (EntityID id : addOrder) {
+            payload.values[0] = static_cast<float>(getEntityIndex(id));
+            storage.add(id, payload);
+        }
+        bench::row("add", timer.ms());
+
+        timer.reset();
+        uint64_t sum = 0;
+        for (EntityID id : accessOrder) {
+            if (const Payload48* p = storage.get(id)) sum += static_cast<uint64_t>(p->values[0]);
+        }
+        bench::row("get", timer.ms());
+        bench::consume(sum);
+
+        timer.reset();
+        uint64_t found = 0;
+        for (EntityID id : accessOrder) {
+            found += storage.has(id) ? 1 : 0;
+        }
+        bench::row("has", timer.ms());
+        bench::consume(found);
+
+        timer.reset();
+        for (EntityID id : removeOrder) {
+            storage.remove(id);
+        }
+        bench::row("remove", timer.ms());
+        bench::consume(storage.size());
+    }
+
+    // ========================================================================
+    // CREATION - Transform + Render + Bounds entities, one at a time vs
+    // World::createEntities
+    // ========================================================================
+
+    void benchCreation(size_t count, StorageMode mode) {
+        const char* storage = mode == StorageMode::Sparse ? "sparse" : "archetype";
+        char name[64];
+
+        {
+            World world(mode);
+            bench::Timer timer;
+            for (size_t i = 0; i < count; ++i) {
+                EntityID id = world.createEntity("Rock", "mesh").getID();
+                world.addComponent(id, RenderComponent{});
+                world.addComponent(id, BoundsComponent{});
+            }
+            std::snprintf(name, sizeof(name), "%s loop", storage);
+            bench::row(name, timer.ms());
+        }
+
+        {
+            World world(mode);
+            EntityPrototype rock("Rock", "mesh");
+            rock.with(RenderComponent{}).with(BoundsComponent{});
+
+            bench::Timer timer;
+            std::vector<EntityID> ids = world.createEntities(count, rock);
+            std::snprintf(name, sizeof(name), "%s createEntities", storage);
+            bench::row(name, timer.ms());
+            bench::consume(ids.size());
+        }
+    }
+
+    // ========================================================================
+    // ITERATION - one loop over Transform/Mesh/Render/Bounds, sparse vs
+    // archetype, with each component type added in entity order or in its
+    // own shuffled order (which scatters the sparse dense arrays)
+    // ========================================================================
+
+    void addIterationComponents(World& world, const std::vector<EntityID>& ids, bool shuffle) {
+        auto order = [&](uint32_t seed) { return shuffle ? shuffled(ids, seed) : ids; };
+
+        for (EntityID id : order(11)) world.addComponent(id, TransformComponent{});
+        for (EntityID id : order(12)) world.addComponent(id, MeshComponent{});
+        for (EntityID id : order(13)) world.addComponent(id, RenderComponent{});
+        for (EntityID id : order(14)) world.addComponent(id, BoundsComponent{});
+    }
+
+    void benchIteration(size_t count, StorageMode mode, bool shuffle) {
+        World world(mode);
+        std::vector<EntityID> ids;
+        ids.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            ids.push_back(world.createEntity("Entity", "mesh").getID());
+        }
+
+        const char* storage = mode == StorageMode::Sparse ? "sparse" : "archetype";
+        const char* order = shuffle ? "shuffled" : "in-order";
+        char name[64];
+
+        bench::Timer timer;
+        addIterationComponents(world, ids, shuffle);
+        std::snprintf(name, sizeof(name), "%s add 4, %s", storage, order);
+        bench::row(name, timer.ms());
+
+        if (mode == StorageMode::Sparse) {
+            timer.reset();
+            float sum = 0.0f;
+            world.forEach<TransformComponent>([&](EntityID id, TransformComponent& t) {
+                const MeshComponent* m = world.getComponent<MeshComponent>(id);
+                const RenderComponent* r = world.getComponent<RenderComponent>(id);
+                const BoundsComponent* b = world.getComponent<BoundsComponent>(id);
+                if (m && r && b) sum += t.position.x + m->boundsMin.x + r->opacity + b->worldRadius;
+            });
+            std::snprintf(name, sizeof(name), "sparse forEach + get, %s", order);
+            bench::row(name, timer.ms());
+            bench::consume(static_cast<uint64_t>(sum));
+        }
+
+        timer.reset();
+        float sum = 0.0f;
+        world.each<TransformComponent, MeshComponent, RenderComponent, BoundsComponent>(
+            [&](EntityID, TransformComponent& t, MeshComponent& m, RenderComponent& r, BoundsComponent& b) {
+                sum += t.position.x + m.boundsMin.x + r.opacity + b.worldRadius;
+            });
+        std::snprintf(name, sizeof(name), "%s each<4>, %s", storage, order);
+        bench::row(name, timer.ms());
+        bench::consume(static_cast<uint64_t>(sum));
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = bench::countArg(argc, argv, 1000000);
+
+    benchStorage(count);
+
+    bench::header("Creating Transform + Render + Bounds entities", count);
+    benchCreation(count, StorageMode::Sparse);
+    benchCreation(count, StorageMode::Archetype);
+
+    bench::header("Iteration over 4 components", count);
+    for (bool shuffle : { false, true }) {
+        benchIteration(count, StorageMode::Sparse, shuffle);
+        benchIteration(count, StorageMode::Archetype, shuffle);
+    }
+
+    return 0;
+}
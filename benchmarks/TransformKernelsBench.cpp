@@ -0,0 +1,119 @@
+// TransformKernels at every SIMD level the CPU supports.
+// Usage: TransformKernelsBench [transformCount]  (default 1M)
+
+#include "BenchUtil.h"
+
+#include "core/TransformKernels.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace libre;
+
+namespace {
+
+    struct Inputs {
+        std::vector<float> px, py, pz, qx, qy, qz, qw, sx, sy, sz;
+        std::vector<Affine3x4> parentMatrices;
+        std::vector<const Affine3x4*> parents;
+        std::vector<glm::vec3> localMin, localMax;
+
+        explicit Inputs(size_t count) {
+            std::mt19937 rng(22);
+            std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+            for (auto* v : { &px, &py, &pz, &qx, &qy, &qz, &qw, &sx, &sy, &sz }) v->resize(count);
+            parentMatrices.resize(count);
+            parents.resize(count);
+            localMin.resize(count);
+            localMax.resize(count);
+
+            for (size_t i = 0; i < count; ++i) {
+                px[i] = position(rng);
+                py[i] = position(rng);
+                pz[i] = position(rng);
+                glm::quat q = glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+                qx[i] = q.x;
+                qy[i] = q.y;
+                qz[i] = q.z;
+                qw[i] = q.w;
+                sx[i] = scale(rng);
+                sy[i] = scale(rng);
+                sz[i] = scale(rng);
+
+                parentMatrices[i].rows[0].w = position(rng);
+                parents[i] = &parentMatrices[i];
+                localMin[i] = glm::vec3(-unit(rng) - 1.0f);
+                localMax[i] = glm::vec3(unit(rng) + 1.0f);
+            }
+        }
+
+        TRSArrays arrays() const {
+            return TRSArrays{ px.data(), py.data(), pz.data(), qx.data(), qy.data(), qz.data(), qw.data(),
+                sx.data(), sy.data(), sz.data() };
+        }
+    };
+
+    void benchReference(const Inputs& in, size_t count, std::vector<Affine3x4>& out) {
+        bench::Timer timer;
+        for (size_t i = 0; i < count; ++i) {
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(in.px[i], in.py[i], in.pz[i]))
+                * glm::mat4_cast(glm::quat(in.qw[i], in.qx[i], in.qy[i], in.qz[i]))
+                * glm::scale(glm::mat4(1.0f), glm::vec3(in.sx[i], in.sy[i], in.sz[i]));
+            out[i] = Affine3x4::fromMat4(m);
+        }
+        bench::row("glm translate*mat4_cast*scale", timer.ms());
+        bench::consume(static_cast<uint64_t>(out[count / 2].rows[0].w));
+    }
+
+    void benchLevel(SimdLevel level, const Inputs& in, size_t count, std::vector<Affine3x4>& out) {
+        TransformKernels::setLevel(level);
+        const char* levelName = TransformKernels::getLevelName(level);
+        char name[64];
+
+        bench::Timer timer;
+        TransformKernels::composeTRS(in.arrays(), nullptr, count, out.data());
+        std::snprintf(name, sizeof(name), "composeTRS, %s", levelName);
+        bench::row(name, timer.ms());
+
+        timer.reset();
+        TransformKernels::composeTRS(in.arrays(), in.parents.data(), count, out.data());
+        std::snprintf(name, sizeof(name), "composeTRS with parents, %s", levelName);
+        bench::row(name, timer.ms());
+
+        std::vector<glm::vec3> worldMin(count), worldMax(count);
+        timer.reset();
+        TransformKernels::transformAABBs(out.data(), in.localMin.data(), in.localMax.data(), count,
+            worldMin.data(), worldMax.data());
+        std::snprintf(name, sizeof(name), "transformAABBs, %s", levelName);
+        bench::row(name, timer.ms());
+
+        bench::consume(static_cast<uint64_t>(out[count / 2].rows[0].w + worldMax[count / 2].x));
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = bench::countArg(argc, argv, 1000000);
+
+    Inputs inputs(count);
+    std::vector<Affine3x4> out(count);
+
+    bench::header("TransformKernels", count);
+    benchReference(inputs, count, out);
+
+    SimdLevel supported = TransformKernels::getSupportedLevel();
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 }) {
+        if (level <= supported) benchLevel(level, inputs, count, out);
+    }
+    TransformKernels::setLevel(supported);
+
+    return 0;
+}
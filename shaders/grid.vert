@@ -12,7 +12,7 @@ layout(binding = 0) uniform UniformBufferObject {
 
 // Per-object data via push constants (same as mesh shader)
 layout(push_constant) uniform PushConstants {
-    mat4 model;
+    mat3x4 model;       // Affine world matrix, one row per column
 } push;
 
 layout(location = 0) in vec3 inPosition;
@@ -21,6 +21,7 @@ layout(location = 1) in vec3 inColor;
 layout(location = 0) out vec3 fragColor;
 
 void main() {
-    gl_Position = ubo.projection * ubo.view * push.model * vec4(inPosition, 1.0);
+    vec3 worldPos = vec4(inPosition, 1.0) * push.model;
+    gl_Position = ubo.projection * ubo.view * vec4(worldPos, 1.0);
     fragColor = inColor;
 }
\ No newline at end of file
@@ -10,7 +10,7 @@ layout(binding = 0) uniform UniformBufferObject {
 
 // Per-object data (changes every draw call)
 layout(push_constant) uniform PushConstants {
-    mat4 model;
+    mat3x4 model;       // Affine world matrix, one row per column
 } push;
 
 layout(location = 0) in vec3 inPosition;
@@ -22,10 +22,18 @@ layout(location = 1) out vec3 fragNormal;
 layout(location = 2) out vec3 fragPos;
 
 void main() {
-    vec4 worldPos = push.model * vec4(inPosition, 1.0);
+    vec4 worldPos = vec4(vec4(inPosition, 1.0) * push.model, 1.0);
     gl_Position = ubo.projection * ubo.view * worldPos;
     
     fragPos = worldPos.xyz;
-    fragNormal = mat3(transpose(inverse(push.model))) * inNormal;
+    // Inverse transpose of the 3x3 up to scale: its rows are the cross
+    // products of the model's rows. The fragment shader normalizes; only a
+    // mirroring model (negative determinant) needs the sign flipped.
+    vec3 r0 = push.model[0].xyz;
+    vec3 r1 = push.model[1].xyz;
+    vec3 r2 = push.model[2].xyz;
+    vec3 c0 = cross(r1, r2);
+    float flip = dot(r0, c0) < 0.0 ? -1.0 : 1.0;
+    fragNormal = flip * (inNormal * mat3(c0, cross(r2, r0), cross(r0, r1)));
     fragColor = inColor;
 }
\ No newline at end of file
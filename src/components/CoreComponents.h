@@ -6,6 +6,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include "../world/Types.h"
+#include "../core/Affine3x4.h"
+
 #include <vector>
 #include <cstdint>
 #include <string>
@@ -21,22 +24,25 @@ namespace libre {
         glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
         glm::vec3 scale = glm::vec3(1.0f);
 
-        // Cached world matrix
-        glm::mat4 worldMatrix = glm::mat4(1.0f);
-        bool dirty = true;
+        // Cached world matrix, recomputed by TransformSystem for transforms
+        // written through getMut and everything below them
+        Affine3x4 worldMatrix;
 
-        // Compute local transform matrix
+        // Compute local transform matrix: T * R * S, built directly from the
+        // rotation columns (TransformKernels::composeTRS does batches)
         glm::mat4 getLocalMatrix() const {
-            glm::mat4 t = glm::translate(glm::mat4(1.0f), position);
-            glm::mat4 r = glm::mat4_cast(rotation);
-            glm::mat4 s = glm::scale(glm::mat4(1.0f), scale);
-            return t * r * s;
+            glm::mat3 r = glm::mat3_cast(rotation);
+            glm::mat4 m;
+            m[0] = glm::vec4(r[0] * scale.x, 0.0f);
+            m[1] = glm::vec4(r[1] * scale.y, 0.0f);
+            m[2] = glm::vec4(r[2] * scale.z, 0.0f);
+            m[3] = glm::vec4(position, 1.0f);
+            return m;
         }
 
         // Helper setters
         void setPosition(float x, float y, float z) {
             position = glm::vec3(x, y, z);
-            dirty = true;
         }
 
         void setRotationEuler(float pitch, float yaw, float roll) {
@@ -45,17 +51,14 @@ namespace libre {
                 glm::radians(yaw),
                 glm::radians(roll)
             ));
-            dirty = true;
         }
 
         void setScale(float uniform) {
             scale = glm::vec3(uniform);
-            dirty = true;
         }
 
         void setScale(float x, float y, float z) {
             scale = glm::vec3(x, y, z);
-            dirty = true;
         }
     };
 
@@ -81,7 +84,6 @@ namespace libre {
         // GPU buffer handles (set by renderer)
         uint64_t vertexBufferHandle = 0;
         uint64_t indexBufferHandle = 0;
-        bool gpuDirty = true;
 
         // Calculate bounds from vertices
         void calculateBounds() {
@@ -110,8 +112,19 @@ namespace libre {
         size_t getVertexCount() const { return vertices.size(); }
         size_t getIndexCount() const { return indices.size(); }
         size_t getTriangleCount() const { return indices.size() / 3; }
+
+        // Vertex and index buffers, for the world memory report
+        MemoryUsage getHeapMemory() const {
+            MemoryUsage usage = vectorMemory(vertices);
+            usage += vectorMemory(indices);
+            return usage;
+        }
     };
 
+    // Meshes are large and referenced by the renderer; keep their addresses
+    // stable and never move them when the storage grows
+    template<> struct ComponentStorageTraits<MeshComponent> : PagedStorage<64> {};
+
     // ============================================================================
     // RENDER COMPONENT - Visual properties
     // ============================================================================
@@ -157,35 +170,27 @@ namespace libre {
         glm::vec3 worldCenter = glm::vec3(0.0f);
         float worldRadius = 1.0f;  // Bounding sphere
 
-        bool dirty = true;
-
-        // Update world bounds from transform
-        void updateWorldBounds(const glm::mat4& worldMatrix) {
-            // Transform all 8 corners of local AABB
-            glm::vec3 corners[8] = {
-                glm::vec3(localMin.x, localMin.y, localMin.z),
-                glm::vec3(localMax.x, localMin.y, localMin.z),
-                glm::vec3(localMin.x, localMax.y, localMin.z),
-                glm::vec3(localMax.x, localMax.y, localMin.z),
-                glm::vec3(localMin.x, localMin.y, localMax.z),
-                glm::vec3(localMax.x, localMin.y, localMax.z),
-                glm::vec3(localMin.x, localMax.y, localMax.z),
-                glm::vec3(localMax.x, localMax.y, localMax.z),
-            };
-
-            worldMin = glm::vec3(std::numeric_limits<float>::max());
-            worldMax = glm::vec3(std::numeric_limits<float>::lowest());
-
-            for (int i = 0; i < 8; ++i) {
-                glm::vec4 transformed = worldMatrix * glm::vec4(corners[i], 1.0f);
-                glm::vec3 p = glm::vec3(transformed);
-                worldMin = glm::min(worldMin, p);
-                worldMax = glm::max(worldMax, p);
+        // Update world bounds from transform. Arvo's method: the box center
+        // goes through the matrix, the half-extent through its absolute
+        // 3x3 part; same box as transforming all 8 corners.
+        void updateWorldBounds(const Affine3x4& worldMatrix) {
+            glm::vec3 center = (localMin + localMax) * 0.5f;
+            glm::vec3 extent = (localMax - localMin) * 0.5f;
+
+            glm::vec3 c = worldMatrix.transformPoint(center);
+            glm::vec3 e;
+            for (int r = 0; r < 3; ++r) {
+                e[r] = glm::dot(glm::abs(glm::vec3(worldMatrix.rows[r])), extent);
             }
+            setWorldBounds(c - e, c + e);
+        }
 
+        // Set the world box directly (batch kernels) and derive the sphere
+        void setWorldBounds(const glm::vec3& min, const glm::vec3& max) {
+            worldMin = min;
+            worldMax = max;
             worldCenter = (worldMin + worldMax) * 0.5f;
             worldRadius = glm::length(worldMax - worldCenter);
-            dirty = false;
         }
 
         // Ray intersection test
@@ -205,33 +210,6 @@ namespace libre {
         }
     };
 
-    // ============================================================================
-    // HIERARCHY COMPONENT - Parent/child relationships
-    // ============================================================================
-
-    struct HierarchyComponent {
-        uint64_t parent = 0;  // INVALID_ENTITY = 0
-        std::vector<uint64_t> children;
-
-        int depth = 0;  // Depth in hierarchy (root = 0)
-
-        bool hasParent() const { return parent != 0; }
-        bool hasChildren() const { return !children.empty(); }
-
-        void addChild(uint64_t child) {
-            if (std::find(children.begin(), children.end(), child) == children.end()) {
-                children.push_back(child);
-            }
-        }
-
-        void removeChild(uint64_t child) {
-            children.erase(
-                std::remove(children.begin(), children.end(), child),
-                children.end()
-            );
-        }
-    };
-
     // ============================================================================
     // NAME COMPONENT - Simple name storage
     // ============================================================================
@@ -0,0 +1,116 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <cmath>
+
+namespace libre {
+
+    // ============================================================================
+    // AFFINE 3x4 - Compact world transform
+    // ============================================================================
+    // The top three rows of an affine mat4; the last row is always (0,0,0,1)
+    // and isn't stored, so a transform is 48 bytes instead of 64. Row r is
+    // (m[0][r], m[1][r], m[2][r], m[3][r]) of the equivalent mat4.
+    //
+    // Uploaded as-is, the rows are the columns of a GLSL mat3x4, and a
+    // point is transformed with  vec4(p, 1.0) * model.
+
+    struct Affine3x4 {
+        glm::vec4 rows[3] = {
+            glm::vec4(1.0f, 0.0f, 0.0f, 0.0f),
+            glm::vec4(0.0f, 1.0f, 0.0f, 0.0f),
+            glm::vec4(0.0f, 0.0f, 1.0f, 0.0f),
+        };
+
+        static Affine3x4 fromMat4(const glm::mat4& m) {
+            Affine3x4 a;
+            for (int r = 0; r < 3; ++r) {
+                a.rows[r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+            }
+            return a;
+        }
+
+        glm::mat4 toMat4() const {
+            glm::mat4 m(1.0f);
+            for (int r = 0; r < 3; ++r) {
+                m[0][r] = rows[r].x;
+                m[1][r] = rows[r].y;
+                m[2][r] = rows[r].z;
+                m[3][r] = rows[r].w;
+            }
+            return m;
+        }
+
+        // Column c of the linear part (the transformed basis axis)
+        glm::vec3 getAxis(int c) const { return glm::vec3(rows[0][c], rows[1][c], rows[2][c]); }
+        glm::vec3 getTranslation() const { return glm::vec3(rows[0].w, rows[1].w, rows[2].w); }
+
+        glm::vec3 transformPoint(const glm::vec3& p) const {
+            glm::vec4 h(p, 1.0f);
+            return glm::vec3(glm::dot(rows[0], h), glm::dot(rows[1], h), glm::dot(rows[2], h));
+        }
+
+        glm::vec3 transformVector(const glm::vec3& v) const {
+            glm::vec4 h(v, 0.0f);
+            return glm::vec3(glm::dot(rows[0], h), glm::dot(rows[1], h), glm::dot(rows[2], h));
+        }
+
+        // this * other, as mat4s would
+        Affine3x4 operator*(const Affine3x4& other) const {
+            Affine3x4 out;
+            for (int r = 0; r < 3; ++r) {
+                const glm::vec4& row = rows[r];
+                out.rows[r] = other.rows[0] * row.x + other.rows[1] * row.y + other.rows[2] * row.z;
+                out.rows[r].w += row.w;
+            }
+            return out;
+        }
+
+        // Inverse transpose of the linear part, for normals. Its rows are
+        // the cross products of the rows over the determinant; a singular
+        // matrix (zero scale) keeps the undivided cofactors, which still
+        // point the right way for the axes that survive.
+        glm::mat3 getNormalMatrix() const {
+            glm::vec3 r0(rows[0]), r1(rows[1]), r2(rows[2]);
+            glm::vec3 n0 = glm::cross(r1, r2);
+            glm::vec3 n1 = glm::cross(r2, r0);
+            glm::vec3 n2 = glm::cross(r0, r1);
+
+            float det = glm::dot(r0, n0);
+            float inv = std::fabs(det) > 0.0f ? 1.0f / det : 1.0f;
+
+            // n0..n2 are rows; glm::mat3 takes columns
+            return glm::mat3(
+                glm::vec3(n0.x, n1.x, n2.x) * inv,
+                glm::vec3(n0.y, n1.y, n2.y) * inv,
+                glm::vec3(n0.z, n1.z, n2.z) * inv);
+        }
+
+        // Inverse transform; false (and 'out' untouched) if the matrix is
+        // singular. The cofactor rows above, transposed and over the
+        // determinant, are the inverse of the linear part.
+        bool getInverse(Affine3x4& out) const {
+            glm::vec3 r0(rows[0]), r1(rows[1]), r2(rows[2]);
+            glm::vec3 n0 = glm::cross(r1, r2);
+            glm::vec3 n1 = glm::cross(r2, r0);
+            glm::vec3 n2 = glm::cross(r0, r1);
+
+            float det = glm::dot(r0, n0);
+            if (det == 0.0f || !std::isfinite(det)) return false;
+            float inv = 1.0f / det;
+
+            glm::vec3 t = getTranslation();
+            for (int r = 0; r < 3; ++r) {
+                glm::vec3 row = glm::vec3(n0[r], n1[r], n2[r]) * inv;
+                out.rows[r] = glm::vec4(row, -glm::dot(row, t));
+            }
+            return true;
+        }
+    };
+
+    static_assert(sizeof(Affine3x4) == 48, "Affine3x4 must match the GLSL mat3x4 layout");
+
+} // namespace libre
@@ -8,6 +8,7 @@
 #include "../world/Primitives.h"
 #include "../components/CoreComponents.h"
 #include <iostream>
+#include <algorithm>
 
 Application::Application() {
     std::cout << "====================================" << std::endl;
@@ -50,6 +51,7 @@ void Application::init() {
     renderer->init(vulkanContext.get(), swapChain.get());
 
     createDefaultScene();
+    setupSystems();
 
     lastFrameTime = std::chrono::steady_clock::now();
 
@@ -57,21 +59,44 @@ void Application::init() {
     printControls();
 }
 
+void Application::setupSystems() {
+    scheduler = std::make_unique<libre::SystemScheduler>();
+
+    // Input and editor commands may touch anything in the world
+    scheduler->addSystem("input", [this](libre::World&, float dt) { processInput(dt); })
+        .exclusive()
+        .mainThread();
+
+    scheduler->addSystem("editor", [](libre::World&, float dt) { libre::Editor::instance().update(dt); })
+        .exclusive()
+        .mainThread();
+
+    transformSystem = std::make_unique<libre::TransformSystem>();
+    spatialIndex = std::make_unique<libre::SpatialIndex>();
+    meshBVHCache = std::make_unique<libre::MeshBVHCache>();
+    scheduler->addSystem("transforms", [this](libre::World& world, float) { transformSystem->update(world); })
+        .writes<libre::TransformComponent, libre::BoundsComponent>()
+        .readsResource("Hierarchy");
+
+    scheduler->addSystem("render", [this](libre::World&, float) { render(); })
+        .reads<libre::MeshComponent, libre::TransformComponent, libre::RenderComponent>()
+        .writesResource("Renderer")
+        .mainThread();
+}
+
 void Application::createDefaultScene() {
     auto& world = libre::Editor::instance().getWorld();
 
     auto cube = libre::Primitives::createCube(world, 2.0f, "DefaultCube");
 
     auto sphere = libre::Primitives::createSphere(world, 1.0f, 32, 16, "Sphere");
-    if (auto* t = sphere.get<libre::TransformComponent>()) {
+    if (auto* t = sphere.getMut<libre::TransformComponent>()) {
         t->position = glm::vec3(3.0f, 0.0f, 0.0f);
-        t->dirty = true;
     }
 
     auto cylinder = libre::Primitives::createCylinder(world, 0.5f, 2.0f, 32, "Cylinder");
-    if (auto* t = cylinder.get<libre::TransformComponent>()) {
+    if (auto* t = cylinder.getMut<libre::TransformComponent>()) {
         t->position = glm::vec3(-3.0f, 0.0f, 0.0f);
-        t->dirty = true;
     }
 
     std::cout << "[OK] Default scene created with "
@@ -91,6 +116,8 @@ void Application::printControls() {
     std::cout << "Ctrl+Z: Undo" << std::endl;
     std::cout << "Ctrl+Shift+Z: Redo" << std::endl;
     std::cout << "Numpad 1/3/7/0: View shortcuts" << std::endl;
+    std::cout << "F3: Print System Timings" << std::endl;
+    std::cout << "F4: Print Memory Report (Shift: shrink first)" << std::endl;
     std::cout << "F11: Toggle Fullscreen" << std::endl;
     std::cout << "ESC: Exit" << std::endl;
     std::cout << "================\n" << std::endl;
@@ -152,14 +179,18 @@ void Application::mainLoop() {
             continue;
         }
 
-        // Process input
-        processInput(deltaTime);
-
-        // Update game state
-        update(deltaTime);
+        // Input, editor, transforms and render, ordered by data access
+        auto& world = libre::Editor::instance().getWorld();
+        scheduler->run(world, deltaTime);
 
-        // Render
-        render();
+        // Sync point: no system is running
+        world.flushDestroyed();
+        world.dispatchObservers();
+        world.updateHierarchyIndex();
+        spatialIndex->sync(world);
+        meshBVHCache->sync(world);
+        world.trimChangeLogs(std::min({ transformSystem->getSyncTick(), spatialIndex->getSyncTick(),
+            meshBVHCache->getSyncTick(), renderSyncTick }));
 
         // Update input state for next frame
         inputManager->update();
@@ -177,6 +208,11 @@ void Application::processInput(float dt) {
         glfwSetWindowShouldClose(window->getHandle(), GLFW_TRUE);
     }
 
+    // System timing report
+    if (inputManager->isKeyJustPressed(GLFW_KEY_F3) && scheduler) {
+        std::cout << scheduler->getTimingReport();
+    }
+
     // Toggle fullscreen with F11
     if (inputManager->isKeyJustPressed(GLFW_KEY_F11)) {
         static bool isFullscreen = false;
@@ -215,6 +251,15 @@ void Application::processInput(float dt) {
     altHeld = inputManager->isKeyPressed(GLFW_KEY_LEFT_ALT) ||
         inputManager->isKeyPressed(GLFW_KEY_RIGHT_ALT);
 
+    // ECS memory report (Shift reclaims slack first)
+    if (inputManager->isKeyJustPressed(GLFW_KEY_F4)) {
+        auto& world = editor.getWorld();
+        if (shiftHeld) {
+            world.shrinkToFit();
+        }
+        std::cout << world.memoryReport().toString();
+    }
+
     // Undo/Redo
     if (ctrlHeld && inputManager->isKeyJustPressed(GLFW_KEY_Z)) {
         if (shiftHeld) {
@@ -268,52 +313,19 @@ void Application::handleSelection() {
     libre::Ray ray = libre::SelectionSystem::screenToRay(
         *camera, mouseX, mouseY, width, height);
 
-    libre::HitResult hit = libre::SelectionSystem::raycast(world, ray);
+    libre::HitResult hit = libre::SelectionSystem::raycast(world, *spatialIndex, *meshBVHCache, ray);
 
     if (hit.hit()) {
         editor.select(hit.entity, shiftHeld);
 
-        auto* meta = world.getMetadata(hit.entity);
-        if (meta) {
-            std::cout << "[Selected] " << meta->name
-                << " (distance: " << hit.distance << ")" << std::endl;
-        }
+        std::cout << "[Selected] " << world.getName(hit.entity)
+            << " (distance: " << hit.distance << ")" << std::endl;
     }
     else if (!shiftHeld) {
         editor.deselectAll();
     }
 }
 
-void Application::update(float dt) {
-    libre::Editor::instance().update(dt);
-    updateTransforms();
-}
-
-void Application::updateTransforms() {
-    auto& world = libre::Editor::instance().getWorld();
-
-    world.forEach<libre::TransformComponent>([&](libre::EntityID id, libre::TransformComponent& t) {
-        if (t.dirty) {
-            if (world.getParent(id) == libre::INVALID_ENTITY) {
-                t.worldMatrix = t.getLocalMatrix();
-            }
-            else {
-                auto* parentT = world.getComponent<libre::TransformComponent>(world.getParent(id));
-                if (parentT) {
-                    t.worldMatrix = parentT->worldMatrix * t.getLocalMatrix();
-                }
-            }
-
-            auto* bounds = world.getComponent<libre::BoundsComponent>(id);
-            if (bounds) {
-                bounds->updateWorldBounds(t.worldMatrix);
-            }
-
-            t.dirty = false;
-        }
-        });
-}
-
 void Application::render() {
     syncECSToRenderer();
 
@@ -329,47 +341,72 @@ void Application::syncECSToRenderer() {
     static bool debugPrinted = false;
     int entityCount = 0;
 
-    world.forEach<libre::MeshComponent>([&](libre::EntityID id, libre::MeshComponent& meshComp) {
-        auto* transform = world.getComponent<libre::TransformComponent>(id);
-        auto* render = world.getComponent<libre::RenderComponent>(id);
+    // Drop GPU copies of meshes that were removed or edited since the last
+    // sync; they are re-uploaded below. Vertex colors bake in baseColor, so
+    // render component writes invalidate too.
+    uint32_t now = world.advanceChangeTick();
+    std::vector<libre::EntityID> stale;
+    world.removed<libre::MeshComponent>(renderSyncTick, [&](libre::EntityID id) {
+        stale.push_back(id);
+        });
+    world.changed<libre::MeshComponent>(renderSyncTick, [&](libre::EntityID id, libre::MeshComponent&) {
+        stale.push_back(id);
+        });
+    world.changed<libre::RenderComponent>(renderSyncTick, [&](libre::EntityID id, libre::RenderComponent&) {
+        stale.push_back(id);
+        });
+
+    if (!stale.empty()) {
+        renderer->waitIdle();
+        for (libre::EntityID id : stale) {
+            renderer->removeMesh(id);
+        }
+    }
+    renderSyncTick = now;
+
+    world.each<libre::MeshComponent, libre::TransformComponent, libre::RenderComponent>(
+        [&](libre::EntityID id, libre::MeshComponent& meshComp,
+            libre::TransformComponent& transform, libre::RenderComponent& render) {
 
         if (!debugPrinted) {
-            auto* meta = world.getMetadata(id);
-            std::cout << "[Sync] Entity: " << (meta ? meta->name : "?")
+            std::cout << "[Sync] Entity: " << world.getName(id)
                 << " ID=" << id
                 << " Verts=" << meshComp.vertices.size()
                 << " Indices=" << meshComp.indices.size() << std::endl;
         }
 
-        if (!transform || !render || !render->visible) {
+        if (!render.visible) {
             return;
         }
 
-        // Convert MeshVertex to Vertex
-        std::vector<Vertex> vulkanVertices;
-        vulkanVertices.reserve(meshComp.vertices.size());
+        Mesh* gpuMesh = renderer->findMesh(id);
+        if (!gpuMesh) {
+            // Convert MeshVertex to Vertex
+            std::vector<Vertex> vulkanVertices;
+            vulkanVertices.reserve(meshComp.vertices.size());
+
+            for (const auto& v : meshComp.vertices) {
+                Vertex vk;
+                vk.position = v.position;
+                vk.normal = v.normal;
+                vk.color = render.baseColor;
+                vulkanVertices.push_back(vk);
+            }
 
-        for (const auto& v : meshComp.vertices) {
-            Vertex vk;
-            vk.position = v.position;
-            vk.normal = v.normal;
-            vk.color = render->baseColor;
-            vulkanVertices.push_back(vk);
+            gpuMesh = renderer->getOrCreateMesh(
+                id,
+                vulkanVertices.data(),
+                vulkanVertices.size(),
+                meshComp.indices.data(),
+                meshComp.indices.size()
+            );
         }
 
-        Mesh* gpuMesh = renderer->getOrCreateMesh(
-            id,
-            vulkanVertices.data(),
-            vulkanVertices.size(),
-            meshComp.indices.data(),
-            meshComp.indices.size()
-        );
-
         bool selected = world.isSelected(id);
         glm::vec3 color = selected ?
-            glm::vec3(1.0f, 0.6f, 0.2f) : render->baseColor;
+            glm::vec3(1.0f, 0.6f, 0.2f) : render.baseColor;
 
-        renderer->submitMesh(gpuMesh, transform->worldMatrix, color, selected);
+        renderer->submitMesh(gpuMesh, transform.worldMatrix, color, selected);
         entityCount++;
         });
 
@@ -382,6 +419,11 @@ void Application::syncECSToRenderer() {
 void Application::cleanup() {
     std::cout << "\n[CLEANUP]" << std::endl;
 
+    if (scheduler) {
+        std::cout << scheduler->getTimingReport();
+        scheduler.reset();
+    }
+
     if (renderer) {
         renderer->waitIdle();
         renderer->cleanup();
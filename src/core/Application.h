@@ -4,6 +4,10 @@
 #include "InputManager.h"
 #include "Camera.h"
 #include "CameraController.h"
+#include "SystemScheduler.h"
+#include "TransformSystem.h"
+#include "SpatialIndex.h"
+#include "MeshBVH.h"
 #include "../render/VulkanContext.h"
 #include <memory>
 #include <chrono>
@@ -23,7 +27,7 @@ private:
     void init();
     void mainLoop();
     void cleanup();
-    void update(float deltaTime);
+    void setupSystems();
     void render();
 
     // Resize handling
@@ -34,7 +38,6 @@ private:
 
     // ECS integration
     void createDefaultScene();
-    void updateTransforms();
     void syncECSToRenderer();
     void handleSelection();
     void printControls();
@@ -52,6 +55,12 @@ private:
     std::unique_ptr<SwapChain> swapChain;
     std::unique_ptr<Renderer> renderer;
 
+    // Per-frame systems (input, editor, transforms, render)
+    std::unique_ptr<libre::SystemScheduler> scheduler;
+    std::unique_ptr<libre::TransformSystem> transformSystem;
+    std::unique_ptr<libre::SpatialIndex> spatialIndex;
+    std::unique_ptr<libre::MeshBVHCache> meshBVHCache;
+
     // Timing
     std::chrono::steady_clock::time_point lastFrameTime;
     float deltaTime = 0.0f;
@@ -65,6 +74,10 @@ private:
     // Resize tracking
     bool framebufferResized = false;
 
+    // Last world change tick seen by the renderer (see World::advanceChangeTick);
+    // the transform system tracks its own
+    uint32_t renderSyncTick = 0;
+
     // Configuration
     static constexpr int WINDOW_WIDTH = 1280;
     static constexpr int WINDOW_HEIGHT = 720;
@@ -7,6 +7,8 @@
 #include <deque>
 #include <queue>
 #include <mutex>
+#include <optional>
+#include <unordered_map>
 
 namespace libre {
 
@@ -58,6 +60,47 @@ namespace libre {
         EntityID createdId_ = INVALID_ENTITY;
     };
 
+    // ============================================================================
+    // SAVED COMPONENTS - Geometry held by delete commands while undoable
+    // ============================================================================
+    // Moved out of the world before the entity is destroyed and moved back on
+    // undo, so deleting and restoring a large mesh never copies its buffers.
+
+    struct SavedComponents {
+        std::optional<MeshComponent> mesh;
+        std::optional<RenderComponent> render;
+        std::optional<BoundsComponent> bounds;
+
+        void capture(World& world, EntityID id) {
+            take(world, id, mesh);
+            take(world, id, render);
+            take(world, id, bounds);
+        }
+
+        void restore(World& world, EntityID id) {
+            give(world, id, mesh);
+            give(world, id, render);
+            give(world, id, bounds);
+        }
+
+    private:
+        template<typename T>
+        static void take(World& world, EntityID id, std::optional<T>& slot) {
+            slot.reset();
+            if (T* component = world.getComponent<T>(id)) {
+                slot.emplace(std::move(*component));
+            }
+        }
+
+        template<typename T>
+        static void give(World& world, EntityID id, std::optional<T>& slot) {
+            if (slot) {
+                world.addComponent<T>(id, std::move(*slot));
+                slot.reset();
+            }
+        }
+    };
+
     // ============================================================================
     // DELETE ENTITY COMMAND
     // ============================================================================
@@ -67,17 +110,16 @@ namespace libre {
         DeleteEntityCommand(EntityID entity) : entityId_(entity) {}
 
         void execute(World& world) override {
-            if (auto* meta = world.getMetadata(entityId_)) {
-                savedName_ = meta->name;
-                savedType_ = meta->type;
-                savedFlags_ = meta->flags;
-            }
+            savedName_ = world.getName(entityId_);
+            savedType_ = world.getType(entityId_);
+            savedFlags_ = world.getFlags(entityId_);
             savedParent_ = world.getParent(entityId_);
 
             if (auto* t = world.getComponent<TransformComponent>(entityId_)) {
                 savedTransform_ = *t;
                 hasTransform_ = true;
             }
+            savedComponents_.capture(world, entityId_);
 
             world.destroyEntity(entityId_);
         }
@@ -86,9 +128,7 @@ namespace libre {
             auto handle = world.createEntity(savedName_, savedType_);
             entityId_ = handle.getID();
 
-            if (auto* meta = world.getMetadata(entityId_)) {
-                meta->flags = savedFlags_;
-            }
+            world.setFlags(entityId_, savedFlags_);
 
             if (savedParent_ != INVALID_ENTITY) {
                 world.setParent(entityId_, savedParent_);
@@ -97,6 +137,7 @@ namespace libre {
             if (hasTransform_) {
                 world.addComponent<TransformComponent>(entityId_, savedTransform_);
             }
+            savedComponents_.restore(world, entityId_);
         }
 
         std::string getName() const override { return "Delete Entity"; }
@@ -109,6 +150,86 @@ namespace libre {
         EntityID savedParent_ = INVALID_ENTITY;
         TransformComponent savedTransform_;
         bool hasTransform_ = false;
+        SavedComponents savedComponents_;
+    };
+
+    // ============================================================================
+    // DELETE ENTITIES COMMAND - One batched destroy for a whole selection
+    // ============================================================================
+
+    class DeleteEntitiesCommand : public Command {
+    public:
+        explicit DeleteEntitiesCommand(std::vector<EntityID> entities)
+            : entityIds_(std::move(entities)) {
+        }
+
+        void execute(World& world) override {
+            saved_.clear();
+            saved_.reserve(entityIds_.size());
+
+            for (EntityID id : entityIds_) {
+                if (!world.entityExists(id)) continue;
+
+                SavedEntity saved;
+                saved.id = id;
+                saved.name = world.getName(id);
+                saved.type = world.getType(id);
+                saved.flags = world.getFlags(id);
+                saved.parent = world.getParent(id);
+                if (auto* t = world.getComponent<TransformComponent>(id)) {
+                    saved.transform = *t;
+                    saved.hasTransform = true;
+                }
+                saved.components.capture(world, id);
+                saved_.push_back(std::move(saved));
+            }
+
+            world.destroyEntities(entityIds_);
+        }
+
+        void undo(World& world) override {
+            // Recreated entities get new IDs; parents deleted in the same
+            // batch are remapped to theirs
+            std::unordered_map<EntityID, EntityID> remap;
+            entityIds_.clear();
+
+            for (auto& saved : saved_) {
+                EntityID id = world.createEntity(saved.name, saved.type).getID();
+                remap[saved.id] = id;
+                entityIds_.push_back(id);
+
+                world.setFlags(id, saved.flags);
+                if (saved.hasTransform) {
+                    world.addComponent<TransformComponent>(id, saved.transform);
+                }
+                saved.components.restore(world, id);
+            }
+
+            for (const auto& saved : saved_) {
+                if (saved.parent == INVALID_ENTITY) continue;
+
+                auto it = remap.find(saved.parent);
+                EntityID parent = it != remap.end() ? it->second : saved.parent;
+                world.setParent(remap[saved.id], parent);
+            }
+        }
+
+        std::string getName() const override { return "Delete Entities"; }
+
+    private:
+        struct SavedEntity {
+            EntityID id = INVALID_ENTITY;
+            std::string name;
+            std::string type;
+            EntityFlags flags = EntityFlags::Default;
+            EntityID parent = INVALID_ENTITY;
+            TransformComponent transform;
+            bool hasTransform = false;
+            SavedComponents components;
+        };
+
+        std::vector<EntityID> entityIds_;
+        std::vector<SavedEntity> saved_;
     };
 
     // ============================================================================
@@ -125,7 +246,7 @@ namespace libre {
         }
 
         void execute(World& world) override {
-            auto* t = world.getComponent<TransformComponent>(entityId_);
+            auto* t = world.getMut<TransformComponent>(entityId_);
             if (!t) return;
 
             oldPosition_ = t->position;
@@ -135,17 +256,15 @@ namespace libre {
             t->position = position_;
             t->rotation = rotation_;
             t->scale = scale_;
-            t->dirty = true;
         }
 
         void undo(World& world) override {
-            auto* t = world.getComponent<TransformComponent>(entityId_);
+            auto* t = world.getMut<TransformComponent>(entityId_);
             if (!t) return;
 
             t->position = oldPosition_;
             t->rotation = oldRotation_;
             t->scale = oldScale_;
-            t->dirty = true;
         }
 
         bool canMergeWith(const Command& other) const override {
@@ -239,16 +358,14 @@ namespace libre {
         }
 
         void execute(World& world) override {
-            if (auto* meta = world.getMetadata(entityId_)) {
-                oldName_ = meta->name;
-                meta->name = name_;
+            if (world.entityExists(entityId_)) {
+                oldName_ = world.getName(entityId_);
+                world.setName(entityId_, name_);
             }
         }
 
         void undo(World& world) override {
-            if (auto* meta = world.getMetadata(entityId_)) {
-                meta->name = oldName_;
-            }
+            world.setName(entityId_, oldName_);
         }
 
         std::string getName() const override { return "Rename"; }
@@ -0,0 +1,487 @@
+#include "DynamicBVH.h"
+
+namespace libre {
+
+    // ============================================================================
+    // BUILD
+    // ============================================================================
+
+    void DynamicBVH::build(const EntityID* entities, const glm::vec3* mins, const glm::vec3* maxs, size_t count) {
+        clear();
+        if (count == 0) return;
+
+        std::vector<BuildRef> refs(count);
+        BuildRange range;
+        for (size_t i = 0; i < count; ++i) {
+            refs[i] = { mins[i], maxs[i], (mins[i] + maxs[i]) * 0.5f, entities[i] };
+            range.grow(refs[i]);
+        }
+        range.begin = 0;
+        range.end = count;
+
+        nodes_.reserve(count * 2 - 1);
+        root_ = buildRange(refs, range, NONE, 0);
+        leafCount_ = count;
+    }
+
+    uint32_t DynamicBVH::buildRange(std::vector<BuildRef>& refs, const BuildRange& range, uint32_t parent, uint32_t depth) {
+        uint32_t node = allocateNode();
+        nodes_[node].min = range.min;
+        nodes_[node].max = range.max;
+        nodes_[node].parent = parent;
+
+        size_t count = range.end - range.begin;
+        if (count == 1) {
+            nodes_[node].entity = refs[range.begin].entity;
+            setLeaf(refs[range.begin].entity, node);
+            return node;
+        }
+
+        BuildRange left;
+        BuildRange right;
+        bool split = depth < MAX_SAH_DEPTH && count > SAH_MIN_COUNT && splitSAH(refs, range, left, right);
+        if (!split) splitMedian(refs, range, left, right);
+
+        uint32_t child0 = buildRange(refs, left, node, depth + 1);
+        uint32_t child1 = buildRange(refs, right, node, depth + 1);
+        Node& n = nodes_[node];
+        n.child0 = child0;
+        n.child1 = child1;
+        n.height = 1 + std::max(nodes_[child0].height, nodes_[child1].height);
+        return node;
+    }
+
+    // Binned SAH: cost of a split = left count * left area + right count *
+    // right area, at every bin boundary on every axis. One pass bins all
+    // three axes; the children's boxes are unions of bins, and their
+    // centroid ranges are the parent's cut at the split (conservative,
+    // which is all binning needs).
+    bool DynamicBVH::splitSAH(std::vector<BuildRef>& refs, const BuildRange& range, BuildRange& left, BuildRange& right) {
+        struct Bin {
+            glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+            size_t count = 0;
+        };
+
+        glm::vec3 extent = range.centroidMax - range.centroidMin;
+        glm::vec3 scale;
+        for (int axis = 0; axis < 3; ++axis) {
+            scale[axis] = extent[axis] > 0.0f ? SAH_BINS / extent[axis] : 0.0f;
+        }
+        auto binOf = [&](const BuildRef& ref, int axis) {
+            int b = static_cast<int>((ref.centroid[axis] - range.centroidMin[axis]) * scale[axis]);
+            return std::min(std::max(b, 0), SAH_BINS - 1);
+        };
+
+        Bin bins[3][SAH_BINS];
+        for (size_t i = range.begin; i < range.end; ++i) {
+            const BuildRef& ref = refs[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                Bin& bin = bins[axis][binOf(ref, axis)];
+                bin.min = glm::min(bin.min, ref.min);
+                bin.max = glm::max(bin.max, ref.max);
+                ++bin.count;
+            }
+        }
+
+        size_t count = range.end - range.begin;
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        int bestSplit = 0;
+        Bin bestLeft;
+        Bin bestRight;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f) continue;
+
+            // Everything right of each boundary as one box
+            Bin rights[SAH_BINS];
+            for (int b = SAH_BINS - 1; b > 0; --b) {
+                Bin& r = rights[b - 1];
+                r = b < SAH_BINS - 1 ? rights[b] : Bin{};
+                r.min = glm::min(r.min, bins[axis][b].min);
+                r.max = glm::max(r.max, bins[axis][b].max);
+                r.count += bins[axis][b].count;
+            }
+
+            Bin l;
+            for (int b = 0; b < SAH_BINS - 1; ++b) {
+                l.min = glm::min(l.min, bins[axis][b].min);
+                l.max = glm::max(l.max, bins[axis][b].max);
+                l.count += bins[axis][b].count;
+                if (l.count == 0 || l.count == count) continue;
+
+                const Bin& r = rights[b];
+                float cost = l.count * surfaceArea(l.min, l.max) + r.count * surfaceArea(r.min, r.max);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                    bestLeft = l;
+                    bestRight = r;
+                }
+            }
+        }
+        if (bestAxis < 0) return false;
+
+        auto middle = std::partition(refs.begin() + range.begin, refs.begin() + range.end, [&](const BuildRef& ref) {
+            return binOf(ref, bestAxis) <= bestSplit;
+            });
+        size_t mid = static_cast<size_t>(middle - refs.begin());
+
+        float cut = range.centroidMin[bestAxis] + (bestSplit + 1) / scale[bestAxis];
+        left = range;
+        left.end = mid;
+        left.min = bestLeft.min;
+        left.max = bestLeft.max;
+        left.centroidMax[bestAxis] = std::min(cut, range.centroidMax[bestAxis]);
+        right = range;
+        right.begin = mid;
+        right.min = bestRight.min;
+        right.max = bestRight.max;
+        right.centroidMin[bestAxis] = std::max(cut, range.centroidMin[bestAxis]);
+        return true;
+    }
+
+    // Halves by centroid on the widest axis: deep ranges and coincident
+    // centroids, where SAH can't or shouldn't split
+    void DynamicBVH::splitMedian(std::vector<BuildRef>& refs, const BuildRange& range, BuildRange& left, BuildRange& right) {
+        glm::vec3 extent = range.centroidMax - range.centroidMin;
+        int axis = 0;
+        if (extent.y > extent[axis]) axis = 1;
+        if (extent.z > extent[axis]) axis = 2;
+
+        size_t mid = range.begin + (range.end - range.begin) / 2;
+        std::nth_element(refs.begin() + range.begin, refs.begin() + mid, refs.begin() + range.end,
+            [axis](const BuildRef& a, const BuildRef& b) { return a.centroid[axis] < b.centroid[axis]; });
+
+        left = BuildRange{};
+        right = BuildRange{};
+        for (size_t i = range.begin; i < mid; ++i) left.grow(refs[i]);
+        for (size_t i = mid; i < range.end; ++i) right.grow(refs[i]);
+        left.begin = range.begin;
+        left.end = mid;
+        right.begin = mid;
+        right.end = range.end;
+    }
+
+    // ============================================================================
+    // INCREMENTAL UPDATES
+    // ============================================================================
+
+    void DynamicBVH::insert(EntityID entity, const glm::vec3& min, const glm::vec3& max) {
+        if (contains(entity)) {
+            update(entity, min, max);
+            return;
+        }
+
+        uint32_t leaf = allocateNode();
+        nodes_[leaf].min = min;
+        nodes_[leaf].max = max;
+        nodes_[leaf].entity = entity;
+        setLeaf(entity, leaf);
+        insertLeaf(leaf);
+        ++leafCount_;
+    }
+
+    bool DynamicBVH::remove(EntityID entity) {
+        uint32_t leaf = leafOf(entity);
+        if (leaf == NONE) return false;
+
+        removeLeaf(leaf);
+        leaves_[getEntityIndex(entity)] = NONE;
+        freeNode(leaf);
+        --leafCount_;
+        return true;
+    }
+
+    bool DynamicBVH::update(EntityID entity, const glm::vec3& min, const glm::vec3& max) {
+        uint32_t leaf = leafOf(entity);
+        if (leaf == NONE) return false;
+
+        nodes_[leaf].min = min;
+        nodes_[leaf].max = max;
+
+        // Ancestors whose box doesn't change end the walk
+        for (uint32_t index = nodes_[leaf].parent; index != NONE; index = nodes_[index].parent) {
+            Node& node = nodes_[index];
+            glm::vec3 oldMin = node.min;
+            glm::vec3 oldMax = node.max;
+            fitToChildren(node);
+            if (node.min == oldMin && node.max == oldMax) break;
+        }
+        return true;
+    }
+
+    bool DynamicBVH::setBounds(EntityID entity, const glm::vec3& min, const glm::vec3& max) {
+        uint32_t leaf = leafOf(entity);
+        if (leaf == NONE) return false;
+
+        nodes_[leaf].min = min;
+        nodes_[leaf].max = max;
+        return true;
+    }
+
+    void DynamicBVH::refit() {
+        if (root_ == NONE) return;
+
+        // Reverse pre-order visits children before their parent
+        std::vector<uint32_t> order;
+        order.reserve(nodes_.size() - freeNodes_.size());
+        order.push_back(root_);
+        for (size_t i = 0; i < order.size(); ++i) {
+            const Node& node = nodes_[order[i]];
+            if (!node.isLeaf()) {
+                order.push_back(node.child0);
+                order.push_back(node.child1);
+            }
+        }
+        for (size_t i = order.size(); i-- > 0;) {
+            Node& node = nodes_[order[i]];
+            if (!node.isLeaf()) fitToChildren(node);
+        }
+    }
+
+    bool DynamicBVH::getBounds(EntityID entity, glm::vec3& min, glm::vec3& max) const {
+        uint32_t leaf = leafOf(entity);
+        if (leaf == NONE) return false;
+
+        min = nodes_[leaf].min;
+        max = nodes_[leaf].max;
+        return true;
+    }
+
+    void DynamicBVH::getLeaves(std::vector<EntityID>& entities, std::vector<glm::vec3>& mins, std::vector<glm::vec3>& maxs) const {
+        entities.clear();
+        mins.clear();
+        maxs.clear();
+        entities.reserve(leafCount_);
+        mins.reserve(leafCount_);
+        maxs.reserve(leafCount_);
+
+        for (uint32_t leaf : leaves_) {
+            if (leaf == NONE) continue;
+            const Node& node = nodes_[leaf];
+            entities.push_back(node.entity);
+            mins.push_back(node.min);
+            maxs.push_back(node.max);
+        }
+    }
+
+    void DynamicBVH::clear() {
+        nodes_.clear();
+        freeNodes_.clear();
+        leaves_.clear();
+        root_ = NONE;
+        leafCount_ = 0;
+    }
+
+    // ============================================================================
+    // TREE MAINTENANCE
+    // ============================================================================
+
+    uint32_t DynamicBVH::allocateNode() {
+        if (!freeNodes_.empty()) {
+            uint32_t node = freeNodes_.back();
+            freeNodes_.pop_back();
+            return node;
+        }
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void DynamicBVH::freeNode(uint32_t node) {
+        nodes_[node] = Node{};
+        freeNodes_.push_back(node);
+    }
+
+    void DynamicBVH::setLeaf(EntityID entity, uint32_t node) {
+        uint32_t index = getEntityIndex(entity);
+        if (index >= leaves_.size()) leaves_.resize(static_cast<size_t>(index) + 1, NONE);
+        leaves_[index] = node;
+    }
+
+    void DynamicBVH::fitToChildren(Node& node) {
+        const Node& a = nodes_[node.child0];
+        const Node& b = nodes_[node.child1];
+        node.min = glm::min(a.min, b.min);
+        node.max = glm::max(a.max, b.max);
+        node.height = 1 + std::max(a.height, b.height);
+    }
+
+    void DynamicBVH::insertLeaf(uint32_t leaf) {
+        if (root_ == NONE) {
+            root_ = leaf;
+            nodes_[leaf].parent = NONE;
+            return;
+        }
+
+        // Descend while pairing up further down is cheaper than pairing
+        // here. Pairing with a node costs the area of the new parent; every
+        // ancestor on the way grows too (the inherited cost).
+        glm::vec3 leafMin = nodes_[leaf].min;
+        glm::vec3 leafMax = nodes_[leaf].max;
+        uint32_t index = root_;
+        while (!nodes_[index].isLeaf()) {
+            const Node& node = nodes_[index];
+            float area = surfaceArea(node.min, node.max);
+            float combined = surfaceArea(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+            float cost = 2.0f * combined;
+            float inherited = 2.0f * (combined - area);
+
+            auto descendCost = [&](uint32_t child) {
+                const Node& c = nodes_[child];
+                float merged = surfaceArea(glm::min(c.min, leafMin), glm::max(c.max, leafMax));
+                return c.isLeaf() ? merged + inherited : merged - surfaceArea(c.min, c.max) + inherited;
+            };
+            float cost0 = descendCost(node.child0);
+            float cost1 = descendCost(node.child1);
+
+            if (cost < cost0 && cost < cost1) break;
+            index = cost0 < cost1 ? node.child0 : node.child1;
+        }
+
+        uint32_t sibling = index;
+        uint32_t oldParent = nodes_[sibling].parent;
+        uint32_t newParent = allocateNode();
+
+        Node& parent = nodes_[newParent];
+        parent.parent = oldParent;
+        parent.child0 = sibling;
+        parent.child1 = leaf;
+        fitToChildren(parent);
+        nodes_[sibling].parent = newParent;
+        nodes_[leaf].parent = newParent;
+
+        if (oldParent == NONE) {
+            root_ = newParent;
+        }
+        else if (nodes_[oldParent].child0 == sibling) {
+            nodes_[oldParent].child0 = newParent;
+        }
+        else {
+            nodes_[oldParent].child1 = newParent;
+        }
+
+        for (index = oldParent; index != NONE; index = nodes_[index].parent) {
+            index = balance(index);
+            fitToChildren(nodes_[index]);
+        }
+    }
+
+    void DynamicBVH::removeLeaf(uint32_t leaf) {
+        if (leaf == root_) {
+            root_ = NONE;
+            return;
+        }
+
+        uint32_t parent = nodes_[leaf].parent;
+        uint32_t grandParent = nodes_[parent].parent;
+        uint32_t sibling = nodes_[parent].child0 == leaf ? nodes_[parent].child1 : nodes_[parent].child0;
+
+        nodes_[sibling].parent = grandParent;
+        freeNode(parent);
+
+        if (grandParent == NONE) {
+            root_ = sibling;
+            return;
+        }
+
+        if (nodes_[grandParent].child0 == parent) {
+            nodes_[grandParent].child0 = sibling;
+        }
+        else {
+            nodes_[grandParent].child1 = sibling;
+        }
+
+        for (uint32_t index = grandParent; index != NONE; index = nodes_[index].parent) {
+            index = balance(index);
+            fitToChildren(nodes_[index]);
+        }
+    }
+
+    // Rotate the taller grandchild up if the children's heights differ by
+    // more than one. Returns the node now at a's position.
+    uint32_t DynamicBVH::balance(uint32_t a) {
+        Node& nodeA = nodes_[a];
+        if (nodeA.isLeaf() || nodeA.height < 2) return a;
+
+        uint32_t b = nodeA.child0;
+        uint32_t c = nodeA.child1;
+        Node& nodeB = nodes_[b];
+        Node& nodeC = nodes_[c];
+        int diff = static_cast<int>(nodeC.height) - static_cast<int>(nodeB.height);
+
+        // Rotate C up: A takes C's shorter child, C takes A
+        if (diff > 1) {
+            uint32_t f = nodeC.child0;
+            uint32_t g = nodeC.child1;
+            Node& nodeF = nodes_[f];
+            Node& nodeG = nodes_[g];
+
+            nodeC.child0 = a;
+            nodeC.parent = nodeA.parent;
+            nodeA.parent = c;
+            if (nodeC.parent == NONE) {
+                root_ = c;
+            }
+            else if (nodes_[nodeC.parent].child0 == a) {
+                nodes_[nodeC.parent].child0 = c;
+            }
+            else {
+                nodes_[nodeC.parent].child1 = c;
+            }
+
+            if (nodeF.height > nodeG.height) {
+                nodeC.child1 = f;
+                nodeA.child1 = g;
+                nodeG.parent = a;
+            }
+            else {
+                nodeC.child1 = g;
+                nodeA.child1 = f;
+                nodeF.parent = a;
+            }
+            fitToChildren(nodeA);
+            fitToChildren(nodeC);
+            return c;
+        }
+
+        // Rotate B up, mirrored
+        if (diff < -1) {
+            uint32_t d = nodeB.child0;
+            uint32_t e = nodeB.child1;
+            Node& nodeD = nodes_[d];
+            Node& nodeE = nodes_[e];
+
+            nodeB.child0 = a;
+            nodeB.parent = nodeA.parent;
+            nodeA.parent = b;
+            if (nodeB.parent == NONE) {
+                root_ = b;
+            }
+            else if (nodes_[nodeB.parent].child0 == a) {
+                nodes_[nodeB.parent].child0 = b;
+            }
+            else {
+                nodes_[nodeB.parent].child1 = b;
+            }
+
+            if (nodeD.height > nodeE.height) {
+                nodeB.child1 = d;
+                nodeA.child0 = e;
+                nodeE.parent = a;
+            }
+            else {
+                nodeB.child1 = e;
+                nodeA.child0 = d;
+                nodeD.parent = a;
+            }
+            fitToChildren(nodeA);
+            fitToChildren(nodeB);
+            return b;
+        }
+
+        return a;
+    }
+
+} // namespace libre
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "../world/Types.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace libre {
+
+    struct RayHit {
+        EntityID entity = INVALID_ENTITY;
+        float distance = 0.0f;
+
+        bool hit() const { return entity != INVALID_ENTITY; }
+    };
+
+    // ============================================================================
+    // DYNAMIC BVH - Axis-aligned bounding box tree over entities
+    // ============================================================================
+    // One entity per leaf, internal nodes bound their two children. build()
+    // creates a tree from scratch with binned SAH splits; insert() descends
+    // by the surface area a new sibling would add and rebalances the path
+    // with AVL rotations (as in Box2D's dynamic tree), remove() collapses
+    // the leaf's parent. Moving an entity refits instead of restructuring:
+    // update() fixes the ancestors right away, setBounds() + refit() does a
+    // whole batch in one bottom-up pass. Refits loosen the tree over time;
+    // owners rebuild it now and then (see SpatialIndex).
+    //
+    // Ray queries visit nodes front to back and cost O(log n) for a typical
+    // scene. raycast() is the primitive; the callback sees each leaf the
+    // ray enters and returns the new maximum distance:
+    //
+    //     < 0    ignore the leaf, keep going
+    //     0      stop the query
+    //     d > 0  clip the ray to d (skips everything farther away)
+    //
+    // raycastNearest/All/Any wrap it around a hit test that refines the box
+    // distance (or rejects the entity with a negative value).
+    //
+    // Not thread-safe for writes; any number of concurrent queries is fine.
+
+    class DynamicBVH {
+    public:
+        // Replace the contents with a SAH-built tree over the given boxes
+        void build(const EntityID* entities, const glm::vec3* mins, const glm::vec3* maxs, size_t count);
+
+        // Insert, or move the entity if it's already in the tree
+        void insert(EntityID entity, const glm::vec3& min, const glm::vec3& max);
+        bool remove(EntityID entity);
+
+        // New bounds for an entity in the tree; refits its ancestors
+        bool update(EntityID entity, const glm::vec3& min, const glm::vec3& max);
+
+        // New leaf bounds without touching the ancestors. Call refit() before
+        // querying or changing the tree again.
+        bool setBounds(EntityID entity, const glm::vec3& min, const glm::vec3& max);
+        void refit();
+
+        bool contains(EntityID entity) const { return leafOf(entity) != NONE; }
+        bool getBounds(EntityID entity, glm::vec3& min, glm::vec3& max) const;
+
+        // Every leaf, in node order (for rebuilding elsewhere)
+        void getLeaves(std::vector<EntityID>& entities, std::vector<glm::vec3>& mins, std::vector<glm::vec3>& maxs) const;
+
+        size_t size() const { return leafCount_; }
+        bool empty() const { return leafCount_ == 0; }
+        uint32_t getHeight() const { return root_ != NONE ? nodes_[root_].height : 0; }
+
+        void clear();
+
+        // ========================================================================
+        // RAY QUERIES
+        // ========================================================================
+        // 'direction' needn't be normalized; distances are in units of it.
+
+        // callback(EntityID, float enterDistance) -> float (see above)
+        template<typename Callback>
+        void raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const;
+
+        // hitTest(EntityID, float boxDistance) -> float distance, < 0 for a miss.
+        // Closest accepted hit; entity is INVALID_ENTITY if there is none.
+        template<typename HitTest>
+        RayHit raycastNearest(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, HitTest&& hitTest) const;
+
+        // Every accepted hit, sorted by distance. Returns the number found.
+        template<typename HitTest>
+        size_t raycastAll(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+            std::vector<RayHit>& hits, HitTest&& hitTest) const;
+
+        // Stops at the first accepted hit (occlusion tests)
+        template<typename HitTest>
+        bool raycastAny(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, HitTest&& hitTest) const;
+
+    private:
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+        // SAH build: bins per axis, and the depth after which it falls back
+        // to median splits so degenerate input can't make a deep tree.
+        // Ranges this small split at the median too; binning costs more than
+        // it saves there.
+        static constexpr int SAH_BINS = 16;
+        static constexpr uint32_t MAX_SAH_DEPTH = 40;
+        static constexpr size_t SAH_MIN_COUNT = 8;
+
+        struct Node {
+            glm::vec3 min;
+            uint32_t parent = NONE;
+            glm::vec3 max;
+            uint32_t child0 = NONE;         // NONE for leaves
+            uint32_t child1 = NONE;
+            uint32_t height = 0;            // 0 for leaves
+            EntityID entity = INVALID_ENTITY;
+
+            bool isLeaf() const { return child0 == NONE; }
+        };
+
+        struct BuildRef {
+            glm::vec3 min;
+            glm::vec3 max;
+            glm::vec3 centroid;
+            EntityID entity;
+        };
+
+        // refs[begin, end) with their box and centroid bounds
+        struct BuildRange {
+            size_t begin = 0;
+            size_t end = 0;
+            glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+            glm::vec3 centroidMin = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 centroidMax = glm::vec3(std::numeric_limits<float>::lowest());
+
+            void grow(const BuildRef& ref) {
+                min = glm::min(min, ref.min);
+                max = glm::max(max, ref.max);
+                centroidMin = glm::min(centroidMin, ref.centroid);
+                centroidMax = glm::max(centroidMax, ref.centroid);
+            }
+        };
+
+        // Node index plus entry distance; an inline stack that spills to the
+        // heap on (very) deep trees
+        struct StackEntry {
+            uint32_t node;
+            float distance;
+        };
+
+        class TraversalStack {
+        public:
+            bool empty() const { return size_ == 0; }
+            void push(uint32_t node, float distance) {
+                if (size_ < INLINE_SIZE) {
+                    inline_[size_] = { node, distance };
+                }
+                else {
+                    overflow_.push_back({ node, distance });
+                }
+                ++size_;
+            }
+            StackEntry pop() {
+                --size_;
+                if (size_ < INLINE_SIZE) return inline_[size_];
+                StackEntry entry = overflow_.back();
+                overflow_.pop_back();
+                return entry;
+            }
+
+        private:
+            static constexpr size_t INLINE_SIZE = 64;
+            StackEntry inline_[INLINE_SIZE];
+            std::vector<StackEntry> overflow_;
+            size_t size_ = 0;
+        };
+
+        static float surfaceArea(const glm::vec3& min, const glm::vec3& max) {
+            glm::vec3 d = max - min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        // Slab test; entry distance clamped to 0 (origin inside)
+        static bool intersect(const Node& node, const glm::vec3& origin, const glm::vec3& invDir, float maxDistance, float& enter) {
+            glm::vec3 t0 = (node.min - origin) * invDir;
+            glm::vec3 t1 = (node.max - origin) * invDir;
+            glm::vec3 tNear = glm::min(t0, t1);
+            glm::vec3 tFar = glm::max(t0, t1);
+            float tn = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+            float tf = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+            enter = tn;
+            return tn <= tf;
+        }
+
+        uint32_t leafOf(EntityID entity) const {
+            uint32_t index = getEntityIndex(entity);
+            if (index >= leaves_.size() || leaves_[index] == NONE) return NONE;
+            return nodes_[leaves_[index]].entity == entity ? leaves_[index] : NONE;
+        }
+
+        uint32_t allocateNode();
+        void freeNode(uint32_t node);
+        void setLeaf(EntityID entity, uint32_t node);
+
+        void insertLeaf(uint32_t leaf);
+        void removeLeaf(uint32_t leaf);
+        uint32_t balance(uint32_t node);
+        void fitToChildren(Node& node);
+
+        uint32_t buildRange(std::vector<BuildRef>& refs, const BuildRange& range, uint32_t parent, uint32_t depth);
+        bool splitSAH(std::vector<BuildRef>& refs, const BuildRange& range, BuildRange& left, BuildRange& right);
+        void splitMedian(std::vector<BuildRef>& refs, const BuildRange& range, BuildRange& left, BuildRange& right);
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> freeNodes_;
+        std::vector<uint32_t> leaves_;      // Entity index -> leaf node (NONE if absent)
+        uint32_t root_ = NONE;
+        size_t leafCount_ = 0;
+    };
+
+    // ============================================================================
+    // QUERY TEMPLATES
+    // ============================================================================
+
+    template<typename Callback>
+    void DynamicBVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const {
+        if (root_ == NONE) return;
+
+        // Zero components become tiny ones: no 0 * inf NaNs in the slab test
+        glm::vec3 invDir;
+        for (int i = 0; i < 3; ++i) {
+            float d = direction[i];
+            invDir[i] = 1.0f / (std::fabs(d) > 1e-30f ? d : std::copysign(1e-30f, d));
+        }
+
+        float limit = maxDistance;
+        float enter;
+        if (!intersect(nodes_[root_], origin, invDir, limit, enter)) return;
+
+        TraversalStack stack;
+        stack.push(root_, enter);
+        while (!stack.empty()) {
+            StackEntry entry = stack.pop();
+            if (entry.distance > limit) continue;   // Clipped since it was pushed
+
+            const Node& node = nodes_[entry.node];
+            if (node.isLeaf()) {
+                float result = callback(node.entity, entry.distance);
+                if (result == 0.0f) return;
+                if (result > 0.0f) limit = std::min(limit, result);
+                continue;
+            }
+
+            // Push the far child first so the near one is visited next
+            float enter0, enter1;
+            bool hit0 = intersect(nodes_[node.child0], origin, invDir, limit, enter0);
+            bool hit1 = intersect(nodes_[node.child1], origin, invDir, limit, enter1);
+            if (hit0 && hit1) {
+                if (enter0 <= enter1) {
+                    stack.push(node.child1, enter1);
+                    stack.push(node.child0, enter0);
+                }
+                else {
+                    stack.push(node.child0, enter0);
+                    stack.push(node.child1, enter1);
+                }
+            }
+            else if (hit0) {
+                stack.push(node.child0, enter0);
+            }
+            else if (hit1) {
+                stack.push(node.child1, enter1);
+            }
+        }
+    }
+
+    template<typename HitTest>
+    RayHit DynamicBVH::raycastNearest(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, HitTest&& hitTest) const {
+        RayHit best;
+        best.distance = maxDistance;
+        raycast(origin, direction, maxDistance, [&](EntityID entity, float boxDistance) {
+            float distance = hitTest(entity, boxDistance);
+            if (distance < 0.0f || distance > best.distance) return -1.0f;
+            best.entity = entity;
+            best.distance = distance;
+            return distance;
+            });
+        return best;
+    }
+
+    template<typename HitTest>
+    size_t DynamicBVH::raycastAll(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+        std::vector<RayHit>& hits, HitTest&& hitTest) const {
+        size_t first = hits.size();
+        raycast(origin, direction, maxDistance, [&](EntityID entity, float boxDistance) {
+            float distance = hitTest(entity, boxDistance);
+            if (distance >= 0.0f && distance <= maxDistance) hits.push_back({ entity, distance });
+            return -1.0f;
+            });
+        std::sort(hits.begin() + first, hits.end(), [](const RayHit& a, const RayHit& b) {
+            return a.distance < b.distance;
+            });
+        return hits.size() - first;
+    }
+
+    template<typename HitTest>
+    bool DynamicBVH::raycastAny(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, HitTest&& hitTest) const {
+        bool found = false;
+        raycast(origin, direction, maxDistance, [&](EntityID entity, float boxDistance) {
+            float distance = hitTest(entity, boxDistance);
+            if (distance < 0.0f || distance > maxDistance) return -1.0f;
+            found = true;
+            return 0.0f;
+            });
+        return found;
+    }
+
+} // namespace libre
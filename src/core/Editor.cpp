@@ -167,12 +167,9 @@ namespace libre {
 
     void Editor::deleteSelected() {
         auto selection = world_->getSelection();
+        if (selection.empty()) return;
 
-        auto compound = std::make_unique<CompoundCommand>("Delete Selected");
-        for (EntityID id : selection) {
-            compound->addCommand(std::make_unique<DeleteEntityCommand>(id));
-        }
-        executeCommand(std::move(compound));
+        executeCommand(std::make_unique<DeleteEntitiesCommand>(std::move(selection)));
     }
 
     void Editor::duplicateSelected() {
@@ -180,10 +177,7 @@ namespace libre {
     }
 
     void Editor::setEntityName(EntityID entity, const std::string& name) {
-        std::string oldName;
-        if (auto* meta = world_->getMetadata(entity)) {
-            oldName = meta->name;
-        }
+        std::string oldName = world_->getName(entity);
 
         executeCommand(std::make_unique<RenameEntityCommand>(entity, name));
 
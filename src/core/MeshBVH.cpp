@@ -0,0 +1,426 @@
+#include "MeshBVH.h"
+#include "TransformKernels.h"
+#include "../world/World.h"
+#include "../components/CoreComponents.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LIBRE_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define LIBRE_TARGET(features)
+#else
+#define LIBRE_TARGET(features) __attribute__((target(features)))
+#endif
+#else
+#define LIBRE_KERNELS_X86 0
+#endif
+
+namespace libre {
+
+    namespace {
+
+        float surfaceArea(const glm::vec3& min, const glm::vec3& max) {
+            glm::vec3 d = max - min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        // Slab test; entry distance clamped to 0 (origin inside)
+        bool intersectBox(const glm::vec3& min, const glm::vec3& max, const glm::vec3& origin,
+            const glm::vec3& invDir, float maxDistance, float& enter) {
+            glm::vec3 t0 = (min - origin) * invDir;
+            glm::vec3 t1 = (max - origin) * invDir;
+            glm::vec3 tNear = glm::min(t0, t1);
+            glm::vec3 tFar = glm::max(t0, t1);
+            float tn = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+            float tf = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+            enter = tn;
+            return tn <= tf;
+        }
+
+    } // namespace
+
+    // ============================================================================
+    // BUILD
+    // ============================================================================
+
+    void MeshBVH::build(const MeshComponent& mesh) {
+        clear();
+
+        // Triangles with out-of-range indices are left out
+        size_t vertexCount = mesh.vertices.size();
+        size_t faceCount = mesh.indices.size() / 3;
+        std::vector<BuildTriangle> tris;
+        tris.reserve(faceCount);
+        for (size_t f = 0; f < faceCount; ++f) {
+            const uint32_t* idx = &mesh.indices[f * 3];
+            if (idx[0] >= vertexCount || idx[1] >= vertexCount || idx[2] >= vertexCount) continue;
+
+            const glm::vec3& a = mesh.vertices[idx[0]].position;
+            const glm::vec3& b = mesh.vertices[idx[1]].position;
+            const glm::vec3& c = mesh.vertices[idx[2]].position;
+            BuildTriangle tri;
+            tri.min = glm::min(a, glm::min(b, c));
+            tri.max = glm::max(a, glm::max(b, c));
+            tri.centroid = (a + b + c) * (1.0f / 3.0f);
+            tri.face = static_cast<uint32_t>(f);
+            tris.push_back(tri);
+        }
+        if (tris.empty()) return;
+
+        size_t leafEstimate = (tris.size() + LEAF_SIZE - 1) / LEAF_SIZE * 2;
+        nodes_.reserve(leafEstimate * 2);
+        packs_.reserve(leafEstimate);
+        buildNode(tris, 0, tris.size(), 0, mesh);
+        triangleCount_ = tris.size();
+    }
+
+    void MeshBVH::clear() {
+        nodes_.clear();
+        packs_.clear();
+        triangleCount_ = 0;
+    }
+
+    uint32_t MeshBVH::buildNode(std::vector<BuildTriangle>& tris, size_t begin, size_t end, uint32_t depth, const MeshComponent& mesh) {
+        Node bounds;
+        bounds.min = glm::vec3(std::numeric_limits<float>::max());
+        bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+        glm::vec3 centroidMin = bounds.min;
+        glm::vec3 centroidMax = bounds.max;
+        for (size_t i = begin; i < end; ++i) {
+            bounds.min = glm::min(bounds.min, tris[i].min);
+            bounds.max = glm::max(bounds.max, tris[i].max);
+            centroidMin = glm::min(centroidMin, tris[i].centroid);
+            centroidMax = glm::max(centroidMax, tris[i].centroid);
+        }
+
+        uint32_t node = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back(bounds);
+
+        size_t count = end - begin;
+        if (count <= LEAF_SIZE) {
+            TrianglePack pack = {};
+            for (size_t lane = 0; lane < 4; ++lane) {
+                pack.face[lane] = MeshHit::NO_FACE;
+            }
+            for (size_t lane = 0; lane < count; ++lane) {
+                uint32_t face = tris[begin + lane].face;
+                const uint32_t* idx = &mesh.indices[face * 3];
+                const glm::vec3& a = mesh.vertices[idx[0]].position;
+                glm::vec3 e1 = mesh.vertices[idx[1]].position - a;
+                glm::vec3 e2 = mesh.vertices[idx[2]].position - a;
+                for (int axis = 0; axis < 3; ++axis) {
+                    pack.v0[axis][lane] = a[axis];
+                    pack.e1[axis][lane] = e1[axis];
+                    pack.e2[axis][lane] = e2[axis];
+                }
+                pack.face[lane] = face;
+            }
+
+            nodes_[node].first = static_cast<uint32_t>(packs_.size());
+            nodes_[node].count = static_cast<uint32_t>(count);
+            packs_.push_back(pack);
+            return node;
+        }
+
+        size_t mid = depth < MAX_SAH_DEPTH ? splitSAH(tris, begin, end, centroidMin, centroidMax) : begin;
+        if (mid == begin) {
+            // No useful SAH split (coincident centroids, or too deep): halve
+            // by centroid on the widest axis
+            glm::vec3 extent = centroidMax - centroidMin;
+            int axis = 0;
+            if (extent.y > extent[axis]) axis = 1;
+            if (extent.z > extent[axis]) axis = 2;
+
+            mid = begin + count / 2;
+            std::nth_element(tris.begin() + begin, tris.begin() + mid, tris.begin() + end,
+                [axis](const BuildTriangle& a, const BuildTriangle& b) { return a.centroid[axis] < b.centroid[axis]; });
+        }
+
+        buildNode(tris, begin, mid, depth + 1, mesh);     // Lands at node + 1
+        uint32_t right = buildNode(tris, mid, end, depth + 1, mesh);
+        nodes_[node].first = right;
+        return node;
+    }
+
+    // Binned SAH over triangle centroids; partitions [begin, end) and
+    // returns the split point, or 'begin' if there is none (every centroid
+    // in one bin)
+    size_t MeshBVH::splitSAH(std::vector<BuildTriangle>& tris, size_t begin, size_t end,
+        const glm::vec3& centroidMin, const glm::vec3& centroidMax) const {
+        struct Bin {
+            glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+            size_t count = 0;
+        };
+
+        glm::vec3 extent = centroidMax - centroidMin;
+        glm::vec3 scale;
+        for (int axis = 0; axis < 3; ++axis) {
+            scale[axis] = extent[axis] > 0.0f ? SAH_BINS / extent[axis] : 0.0f;
+        }
+        auto binOf = [&](const BuildTriangle& tri, int axis) {
+            int b = static_cast<int>((tri.centroid[axis] - centroidMin[axis]) * scale[axis]);
+            return std::min(std::max(b, 0), SAH_BINS - 1);
+        };
+
+        Bin bins[3][SAH_BINS];
+        for (size_t i = begin; i < end; ++i) {
+            for (int axis = 0; axis < 3; ++axis) {
+                Bin& bin = bins[axis][binOf(tris[i], axis)];
+                bin.min = glm::min(bin.min, tris[i].min);
+                bin.max = glm::max(bin.max, tris[i].max);
+                ++bin.count;
+            }
+        }
+
+        size_t count = end - begin;
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        int bestSplit = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f) continue;
+
+            float rightCost[SAH_BINS];
+            Bin r;
+            for (int b = SAH_BINS - 1; b > 0; --b) {
+                r.min = glm::min(r.min, bins[axis][b].min);
+                r.max = glm::max(r.max, bins[axis][b].max);
+                r.count += bins[axis][b].count;
+                rightCost[b - 1] = r.count ? r.count * surfaceArea(r.min, r.max) : 0.0f;
+            }
+
+            Bin l;
+            for (int b = 0; b < SAH_BINS - 1; ++b) {
+                l.min = glm::min(l.min, bins[axis][b].min);
+                l.max = glm::max(l.max, bins[axis][b].max);
+                l.count += bins[axis][b].count;
+                if (l.count == 0 || l.count == count) continue;
+
+                float cost = l.count * surfaceArea(l.min, l.max) + rightCost[b];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b;
+                }
+            }
+        }
+        if (bestAxis < 0) return begin;
+
+        auto middle = std::partition(tris.begin() + begin, tris.begin() + end, [&](const BuildTriangle& tri) {
+            return binOf(tri, bestAxis) <= bestSplit;
+            });
+        return static_cast<size_t>(middle - tris.begin());
+    }
+
+    // ============================================================================
+    // QUERIES
+    // ============================================================================
+
+    bool MeshBVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, MeshHit& hit) const {
+        if (nodes_.empty()) return false;
+
+        // Zero components become tiny ones: no 0 * inf NaNs in the slab test
+        glm::vec3 invDir;
+        for (int i = 0; i < 3; ++i) {
+            float d = direction[i];
+            invDir[i] = 1.0f / (std::fabs(d) > 1e-30f ? d : std::copysign(1e-30f, d));
+        }
+
+        bool simd = LIBRE_KERNELS_X86 && TransformKernels::getLevel() >= SimdLevel::SSE41;
+
+        MeshHit best;
+        best.distance = maxDistance;
+
+        float enter;
+        if (!intersectBox(nodes_[0].min, nodes_[0].max, origin, invDir, best.distance, enter)) return false;
+
+        struct Entry {
+            uint32_t node;
+            float distance;
+        };
+        Entry stack[STACK_SIZE];
+        size_t size = 0;
+        stack[size++] = { 0, enter };
+
+        while (size > 0) {
+            Entry entry = stack[--size];
+            if (entry.distance > best.distance) continue;     // Clipped since it was pushed
+
+            const Node& node = nodes_[entry.node];
+            if (node.count > 0) {
+                const TrianglePack& pack = packs_[node.first];
+                if (simd) {
+                    intersectLeafSSE41(pack, origin, direction, best);
+                }
+                else {
+                    intersectLeaf(pack, origin, direction, best);
+                }
+                continue;
+            }
+
+            // Push the far child first so the near one is visited next
+            uint32_t child0 = entry.node + 1;
+            uint32_t child1 = node.first;
+            float enter0, enter1;
+            bool hit0 = intersectBox(nodes_[child0].min, nodes_[child0].max, origin, invDir, best.distance, enter0);
+            bool hit1 = intersectBox(nodes_[child1].min, nodes_[child1].max, origin, invDir, best.distance, enter1);
+            if (hit0 && hit1) {
+                if (enter0 <= enter1) {
+                    stack[size++] = { child1, enter1 };
+                    stack[size++] = { child0, enter0 };
+                }
+                else {
+                    stack[size++] = { child0, enter0 };
+                    stack[size++] = { child1, enter1 };
+                }
+            }
+            else if (hit0) {
+                stack[size++] = { child0, enter0 };
+            }
+            else if (hit1) {
+                stack[size++] = { child1, enter1 };
+            }
+        }
+
+        if (!best.hit()) return false;
+        hit = best;
+        return true;
+    }
+
+    // Moller-Trumbore, lane by lane. Records a lane that's closer than
+    // hit.distance (and in front of the origin).
+    bool MeshBVH::intersectLeaf(const TrianglePack& pack, const glm::vec3& origin, const glm::vec3& direction, MeshHit& hit) const {
+        bool found = false;
+        for (int lane = 0; lane < 4; ++lane) {
+            glm::vec3 v0(pack.v0[0][lane], pack.v0[1][lane], pack.v0[2][lane]);
+            glm::vec3 e1(pack.e1[0][lane], pack.e1[1][lane], pack.e1[2][lane]);
+            glm::vec3 e2(pack.e2[0][lane], pack.e2[1][lane], pack.e2[2][lane]);
+
+            glm::vec3 p = glm::cross(direction, e2);
+            float det = glm::dot(e1, p);
+            if (det == 0.0f) continue;
+            float inv = 1.0f / det;
+
+            glm::vec3 s = origin - v0;
+            float u = glm::dot(s, p) * inv;
+            if (!(u >= 0.0f && u <= 1.0f)) continue;
+
+            glm::vec3 q = glm::cross(s, e1);
+            float v = glm::dot(direction, q) * inv;
+            if (!(v >= 0.0f && u + v <= 1.0f)) continue;
+
+            float t = glm::dot(e2, q) * inv;
+            if (!(t > 0.0f && t < hit.distance)) continue;
+
+            hit.distance = t;
+            hit.face = pack.face[lane];
+            hit.barycentric = glm::vec2(u, v);
+            hit.normal = glm::normalize(glm::cross(e1, e2));
+            found = true;
+        }
+        return found;
+    }
+
+#if LIBRE_KERNELS_X86
+
+    // The same test for all four lanes at once
+    LIBRE_TARGET("sse4.1")
+    bool MeshBVH::intersectLeafSSE41(const TrianglePack& pack, const glm::vec3& origin, const glm::vec3& direction, MeshHit& hit) const {
+        __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+        __m128 e1x = _mm_load_ps(pack.e1[0]), e1y = _mm_load_ps(pack.e1[1]), e1z = _mm_load_ps(pack.e1[2]);
+        __m128 e2x = _mm_load_ps(pack.e2[0]), e2y = _mm_load_ps(pack.e2[1]), e2z = _mm_load_ps(pack.e2[2]);
+
+        // p = direction x e2, det = e1 . p
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 inv = _mm_div_ps(one, det);
+
+        // s = origin - v0, u = (s . p) / det
+        __m128 sx = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_load_ps(pack.v0[0]));
+        __m128 sy = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_load_ps(pack.v0[1]));
+        __m128 sz = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_load_ps(pack.v0[2]));
+        __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv);
+
+        // q = s x e1, v = (direction . q) / det, t = (e2 . q) / det
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv);
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv);
+
+        // det == 0 lanes (unused or degenerate) are out; NaNs fail the
+        // ordered compares
+        __m128 mask = _mm_cmpneq_ps(det, zero);
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+        mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, zero));
+        mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(hit.distance)));
+
+        int bits = _mm_movemask_ps(mask);
+        if (bits == 0) return false;
+
+        alignas(16) float ts[4], us[4], vs[4];
+        _mm_store_ps(ts, t);
+        _mm_store_ps(us, u);
+        _mm_store_ps(vs, v);
+
+        int lane = -1;
+        for (int i = 0; i < 4; ++i) {
+            if ((bits & (1 << i)) && (lane < 0 || ts[i] < ts[lane])) lane = i;
+        }
+
+        glm::vec3 e1(pack.e1[0][lane], pack.e1[1][lane], pack.e1[2][lane]);
+        glm::vec3 e2(pack.e2[0][lane], pack.e2[1][lane], pack.e2[2][lane]);
+        hit.distance = ts[lane];
+        hit.face = pack.face[lane];
+        hit.barycentric = glm::vec2(us[lane], vs[lane]);
+        hit.normal = glm::normalize(glm::cross(e1, e2));
+        return true;
+    }
+
+#else
+
+    bool MeshBVH::intersectLeafSSE41(const TrianglePack& pack, const glm::vec3& origin, const glm::vec3& direction, MeshHit& hit) const {
+        return intersectLeaf(pack, origin, direction, hit);
+    }
+
+#endif
+
+    // ============================================================================
+    // CACHE
+    // ============================================================================
+
+    size_t MeshBVHCache::sync(World& world) {
+        uint32_t now = world.advanceChangeTick();
+
+        size_t dropped = 0;
+        if (!trees_.empty()) {
+            world.removed<MeshComponent>(syncTick_, [&](EntityID id) {
+                dropped += trees_.erase(id);
+                });
+            world.changed<MeshComponent>(syncTick_, [&](EntityID id, MeshComponent&) {
+                dropped += trees_.erase(id);
+                });
+        }
+
+        syncTick_ = now;
+        return dropped;
+    }
+
+    const MeshBVH* MeshBVHCache::get(EntityID entity, const MeshComponent& mesh) {
+        std::unique_ptr<MeshBVH>& tree = trees_[entity];
+        if (!tree) {
+            tree = std::make_unique<MeshBVH>();
+            tree->build(mesh);
+        }
+        return tree->empty() ? nullptr : tree.get();
+    }
+
+} // namespace libre
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../world/Types.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <limits>
+
+namespace libre {
+
+    class World;
+    struct MeshComponent;
+
+    struct MeshHit {
+        static constexpr uint32_t NO_FACE = 0xFFFFFFFF;
+
+        float distance = std::numeric_limits<float>::max();
+        uint32_t face = NO_FACE;                    // Triangle index (indices[3 * face])
+        glm::vec2 barycentric = glm::vec2(0.0f);    // Weights of the face's 2nd and 3rd vertex
+        glm::vec3 normal = glm::vec3(0.0f);         // Unit face normal, mesh space, by winding
+
+        bool hit() const { return face != NO_FACE; }
+    };
+
+    // ============================================================================
+    // MESH BVH - Triangle tree for exact ray hits on one mesh
+    // ============================================================================
+    // Built once from a mesh's positions and indices (binned SAH, at most
+    // four triangles per leaf) and independent of the mesh afterwards.
+    // Each leaf's triangles are stored as one structure-of-arrays pack
+    // (first vertex and two edges), so a leaf is a single 4-wide
+    // Moller-Trumbore test on SSE4.1; the scalar path does the same math
+    // one lane at a time. Which one runs follows TransformKernels::getLevel.
+    //
+    // Both faces of a triangle are hit. Queries are in mesh space; callers
+    // move the ray there (see SelectionSystem).
+
+    class MeshBVH {
+    public:
+        void build(const MeshComponent& mesh);
+        void clear();
+
+        // Nearest triangle within maxDistance along the ray ('direction'
+        // needn't be normalized; distances are in units of it)
+        bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, MeshHit& hit) const;
+
+        bool empty() const { return nodes_.empty(); }
+        size_t getTriangleCount() const { return triangleCount_; }
+        size_t getNodeCount() const { return nodes_.size(); }
+
+    private:
+        static constexpr uint32_t LEAF_SIZE = 4;   // One pack per leaf
+        static constexpr int SAH_BINS = 12;
+        static constexpr uint32_t MAX_SAH_DEPTH = 48;
+        static constexpr size_t STACK_SIZE = 128;
+
+        // Internal: count == 0, left child follows, 'first' is the right
+        // child. Leaf: triangles in pack 'first', 'count' of its lanes used.
+        struct Node {
+            glm::vec3 min;
+            uint32_t first = 0;
+            glm::vec3 max;
+            uint32_t count = 0;
+        };
+
+        // Four triangles, one per lane. Unused lanes have zero edges, which
+        // no ray hits.
+        struct alignas(16) TrianglePack {
+            float v0[3][4];
+            float e1[3][4];
+            float e2[3][4];
+            uint32_t face[4];
+        };
+
+        struct BuildTriangle {
+            glm::vec3 min;
+            glm::vec3 max;
+            glm::vec3 centroid;
+            uint32_t face;
+        };
+
+        uint32_t buildNode(std::vector<BuildTriangle>& tris, size_t begin, size_t end, uint32_t depth, const MeshComponent& mesh);
+        size_t splitSAH(std::vector<BuildTriangle>& tris, size_t begin, size_t end,
+            const glm::vec3& centroidMin, const glm::vec3& centroidMax) const;
+
+        bool intersectLeaf(const TrianglePack& pack, const glm::vec3& origin, const glm::vec3& direction, MeshHit& hit) const;
+        bool intersectLeafSSE41(const TrianglePack& pack, const glm::vec3& origin, const glm::vec3& direction, MeshHit& hit) const;
+
+        std::vector<Node> nodes_;
+        std::vector<TrianglePack> packs_;
+        size_t triangleCount_ = 0;
+    };
+
+    // ============================================================================
+    // MESH BVH CACHE - Triangle trees per MeshComponent, built on demand
+    // ============================================================================
+    // get() builds an entity's tree the first time it's asked for one;
+    // sync() drops the trees of meshes written or removed since the last
+    // sync (the MeshComponent change log), so the next get() rebuilds from
+    // the new data. Call sync() at a sync point, like SpatialIndex.
+    // Not thread-safe.
+
+    class MeshBVHCache {
+    public:
+        // Returns the number of trees dropped
+        size_t sync(World& world);
+
+        // Tree for the entity's mesh; null for a mesh without triangles
+        const MeshBVH* get(EntityID entity, const MeshComponent& mesh);
+
+        void clear() { trees_.clear(); }
+        size_t size() const { return trees_.size(); }
+
+        // Change tick this cache has consumed up to (for trimChangeLogs)
+        uint32_t getSyncTick() const { return syncTick_; }
+
+    private:
+        std::unordered_map<EntityID, std::unique_ptr<MeshBVH>> trees_;
+        uint32_t syncTick_ = 0;
+    };
+
+} // namespace libre
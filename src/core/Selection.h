@@ -3,6 +3,8 @@
 #include "../world/World.h"
 #include "../components/CoreComponents.h"
 #include "Camera.h"
+#include "SpatialIndex.h"
+#include "MeshBVH.h"
 #include <glm/glm.hpp>
 #include <limits>
 
@@ -21,6 +23,10 @@ namespace libre {
         glm::vec3 point = glm::vec3(0.0f);
         glm::vec3 normal = glm::vec3(0.0f);
 
+        // Mesh hits only: triangle and where on it (see MeshHit)
+        uint32_t face = MeshHit::NO_FACE;
+        glm::vec2 barycentric = glm::vec2(0.0f);
+
         bool hit() const { return entity != INVALID_ENTITY; }
     };
 
@@ -58,10 +64,10 @@ namespace libre {
             HitResult closest;
 
             world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
-                // Skip if no transform or not visible
-                auto* meta = world.getMetadata(id);
-                if (meta && !meta->isVisible()) return;
-                if (meta && !meta->isSelectable()) return;
+                // Skip if not visible or not selectable
+                EntityFlags flags = world.getFlags(id);
+                if (!hasFlag(flags, EntityFlags::Visible)) return;
+                if (!hasFlag(flags, EntityFlags::Selectable)) return;
 
                 float tMin, tMax;
                 if (bounds.intersectsRay(ray.origin, ray.direction, tMin, tMax)) {
@@ -78,6 +84,72 @@ namespace libre {
             return closest;
         }
 
+        // Raycast through a SpatialIndex: O(log n) boxes instead of every
+        // one, with the same rules as above (visible, selectable, in front).
+        // Entities with a mesh are hit on their triangles, through the
+        // cache's per-mesh trees; the others on their bounds.
+        static HitResult raycast(World& world, const SpatialIndex& index, MeshBVHCache& meshes, const Ray& ray) {
+            RayHit hit = index.getTree().raycastNearest(ray.origin, ray.direction,
+                std::numeric_limits<float>::max(), PickTest{ world, meshes, ray });
+            return hit.hit() ? makeHit(world, meshes, ray, hit) : HitResult{};
+        }
+
+        // Every pickable entity along the ray, nearest first
+        static std::vector<HitResult> raycastAll(World& world, const SpatialIndex& index, MeshBVHCache& meshes, const Ray& ray) {
+            std::vector<RayHit> hits;
+            index.getTree().raycastAll(ray.origin, ray.direction, std::numeric_limits<float>::max(), hits,
+                PickTest{ world, meshes, ray });
+
+            std::vector<HitResult> results;
+            results.reserve(hits.size());
+            for (const RayHit& hit : hits) results.push_back(makeHit(world, meshes, ray, hit));
+            return results;
+        }
+
+        // True if anything pickable lies within maxDistance along the ray
+        static bool raycastAny(World& world, const SpatialIndex& index, MeshBVHCache& meshes, const Ray& ray,
+            float maxDistance = std::numeric_limits<float>::max()) {
+            return index.getTree().raycastAny(ray.origin, ray.direction, maxDistance, PickTest{ world, meshes, ray });
+        }
+
+        // Nearest triangle of the entity's mesh along the ray, with the
+        // normal in world space. False on a miss or without a mesh.
+        static bool raycastMesh(World& world, MeshBVHCache& meshes, EntityID entity, const Ray& ray, HitResult& result) {
+            const auto* mesh = world.getComponent<MeshComponent>(entity);
+            if (!mesh) return false;
+            const MeshBVH* tree = meshes.get(entity, *mesh);
+            if (!tree) return false;
+
+            // The ray in mesh space keeps its parameter, so distances carry
+            // over unchanged
+            glm::vec3 origin = ray.origin;
+            glm::vec3 direction = ray.direction;
+            const auto* transform = world.getComponent<TransformComponent>(entity);
+            if (transform) {
+                Affine3x4 toMesh;
+                if (!transform->worldMatrix.getInverse(toMesh)) return false;
+                origin = toMesh.transformPoint(origin);
+                direction = toMesh.transformVector(direction);
+            }
+
+            MeshHit hit;
+            if (!tree->raycast(origin, direction, std::numeric_limits<float>::max(), hit)) return false;
+
+            // Winding isn't consistent across meshes; the vertex normals say
+            // which side is out
+            const uint32_t* idx = &mesh->indices[hit.face * 3];
+            glm::vec3 outward = mesh->vertices[idx[0]].normal + mesh->vertices[idx[1]].normal + mesh->vertices[idx[2]].normal;
+            glm::vec3 normal = glm::dot(hit.normal, outward) < 0.0f ? -hit.normal : hit.normal;
+
+            result.entity = entity;
+            result.distance = hit.distance;
+            result.point = ray.origin + ray.direction * hit.distance;
+            result.normal = transform ? glm::normalize(transform->worldMatrix.getNormalMatrix() * normal) : normal;
+            result.face = hit.face;
+            result.barycentric = hit.barycentric;
+            return true;
+        }
+
         // Raycast against specific entity
         static bool raycastEntity(World& world, EntityID entity, const Ray& ray, HitResult& result) {
             auto* bounds = world.getComponent<BoundsComponent>(entity);
@@ -126,9 +198,9 @@ namespace libre {
             glm::mat4 viewProj = camera.getProjectionMatrix() * camera.getViewMatrix();
 
             world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
-                auto* meta = world.getMetadata(id);
-                if (meta && !meta->isVisible()) return;
-                if (meta && !meta->isSelectable()) return;
+                EntityFlags flags = world.getFlags(id);
+                if (!hasFlag(flags, EntityFlags::Visible)) return;
+                if (!hasFlag(flags, EntityFlags::Selectable)) return;
 
                 // Project world center to screen
                 glm::vec4 clipPos = viewProj * glm::vec4(bounds.worldCenter, 1.0f);
@@ -150,6 +222,39 @@ namespace libre {
 
             return selected;
         }
+
+    private:
+        // Hit test for the indexed raycasts: triangle distance for meshes,
+        // box distance otherwise, if pickable
+        struct PickTest {
+            World& world;
+            MeshBVHCache& meshes;
+            const Ray& ray;
+
+            float operator()(EntityID id, float distance) const {
+                EntityFlags flags = world.getFlags(id);
+                if (!hasFlag(flags, EntityFlags::Visible) || !hasFlag(flags, EntityFlags::Selectable)) return -1.0f;
+
+                if (world.hasComponent<MeshComponent>(id)) {
+                    HitResult hit;
+                    return raycastMesh(world, meshes, id, ray, hit) ? hit.distance : -1.0f;
+                }
+                return distance > 0.0f ? distance : -1.0f;
+            }
+        };
+
+        // Redoes the mesh test for the few hits returned rather than
+        // keeping the details of every candidate
+        static HitResult makeHit(World& world, MeshBVHCache& meshes, const Ray& ray, const RayHit& hit) {
+            HitResult result;
+            if (raycastMesh(world, meshes, hit.entity, ray, result)) return result;
+
+            result.entity = hit.entity;
+            result.distance = hit.distance;
+            result.point = ray.origin + ray.direction * hit.distance;
+            result.normal = -ray.direction;
+            return result;
+        }
     };
 
 } // namespace libre
\ No newline at end of file
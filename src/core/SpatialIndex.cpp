@@ -0,0 +1,178 @@
+#include "SpatialIndex.h"
+#include "../world/World.h"
+#include "../components/CoreComponents.h"
+#include <algorithm>
+
+namespace libre {
+
+    SpatialIndex::~SpatialIndex() {
+        cancelRebuild();
+    }
+
+    size_t SpatialIndex::sync(World& world) {
+        uint32_t now = world.advanceChangeTick();
+
+        removed_.clear();
+        changed_.clear();
+        changedMins_.clear();
+        changedMaxs_.clear();
+
+        // First sync (or after clear): the change log may have been trimmed,
+        // so read every bounds and build from scratch
+        if (fullSync_) {
+            cancelRebuild();
+            world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
+                changed_.push_back(id);
+                changedMins_.push_back(bounds.worldMin);
+                changedMaxs_.push_back(bounds.worldMax);
+                });
+            tree_.build(changed_.data(), changedMins_.data(), changedMaxs_.data(), changed_.size());
+
+            changesSinceBuild_ = 0;
+            rebuildRequested_ = false;
+            fullSync_ = false;
+            syncTick_ = now;
+            return changed_.size();
+        }
+
+        // Removals first: an entity that lost its bounds and got new ones
+        // since the last sync is in both lists
+        world.removed<BoundsComponent>(syncTick_, [&](EntityID id) {
+            removed_.push_back(id);
+            });
+        world.changed<BoundsComponent>(syncTick_, [&](EntityID id, BoundsComponent& bounds) {
+            changed_.push_back(id);
+            changedMins_.push_back(bounds.worldMin);
+            changedMaxs_.push_back(bounds.worldMax);
+            });
+
+        // Counted now: an inline rebuild reuses the scratch lists
+        size_t count = removed_.size() + changed_.size();
+        applyChanges();
+        finishRebuild();
+        maybeRebuild();
+
+        syncTick_ = now;
+        return count;
+    }
+
+    void SpatialIndex::clear() {
+        cancelRebuild();
+        tree_.clear();
+        changesSinceBuild_ = 0;
+        rebuildRequested_ = false;
+        fullSync_ = true;
+    }
+
+    void SpatialIndex::applyChanges() {
+        for (EntityID id : removed_) {
+            tree_.remove(id);
+        }
+
+        // Few changes: insert or refit one by one. Many: set the moved
+        // leaves, refit the tree once, then insert the new ones (or rebuild
+        // if new ones outnumber the tree).
+        size_t count = changed_.size();
+        if (count <= tree_.size() * BATCH_REFIT_FRACTION) {
+            for (size_t i = 0; i < count; ++i) {
+                tree_.insert(changed_[i], changedMins_[i], changedMaxs_[i]);
+            }
+        }
+        else {
+            inserted_.clear();
+            for (size_t i = 0; i < count; ++i) {
+                if (!tree_.setBounds(changed_[i], changedMins_[i], changedMaxs_[i])) inserted_.push_back(i);
+            }
+            tree_.refit();
+
+            if (inserted_.size() > tree_.size()) {
+                std::vector<EntityID> entities;
+                std::vector<glm::vec3> mins;
+                std::vector<glm::vec3> maxs;
+                tree_.getLeaves(entities, mins, maxs);
+                for (size_t i : inserted_) {
+                    entities.push_back(changed_[i]);
+                    mins.push_back(changedMins_[i]);
+                    maxs.push_back(changedMaxs_[i]);
+                }
+                tree_.build(entities.data(), mins.data(), maxs.data(), entities.size());
+
+                // A build in flight is older than this one
+                cancelRebuild();
+                changesSinceBuild_ = 0;
+                return;
+            }
+
+            for (size_t i : inserted_) {
+                tree_.insert(changed_[i], changedMins_[i], changedMaxs_[i]);
+            }
+        }
+
+        changesSinceBuild_ += removed_.size() + count;
+        if (job_) {
+            changedSinceSnapshot_.insert(changedSinceSnapshot_.end(), removed_.begin(), removed_.end());
+            changedSinceSnapshot_.insert(changedSinceSnapshot_.end(), changed_.begin(), changed_.end());
+        }
+    }
+
+    void SpatialIndex::maybeRebuild() {
+        if (job_) return;
+
+        size_t threshold = std::max(MIN_REBUILD_CHANGES, static_cast<size_t>(tree_.size() * REBUILD_FRACTION));
+        if (!rebuildRequested_ && changesSinceBuild_ < threshold) return;
+        rebuildRequested_ = false;
+
+        if (tree_.size() >= BACKGROUND_THRESHOLD) {
+            startRebuild();
+            return;
+        }
+
+        // Small enough to rebuild inline; the scratch lists are done with
+        tree_.getLeaves(changed_, changedMins_, changedMaxs_);
+        tree_.build(changed_.data(), changedMins_.data(), changedMaxs_.data(), changed_.size());
+        changesSinceBuild_ = 0;
+    }
+
+    void SpatialIndex::startRebuild() {
+        job_ = std::make_unique<RebuildJob>();
+        tree_.getLeaves(job_->entities, job_->mins, job_->maxs);
+        changedSinceSnapshot_.clear();
+        changesSinceBuild_ = 0;
+
+        RebuildJob* job = job_.get();
+        builder_ = std::thread([job]() {
+            job->tree.build(job->entities.data(), job->mins.data(), job->maxs.data(), job->entities.size());
+            job->done.store(true, std::memory_order_release);
+            });
+    }
+
+    void SpatialIndex::finishRebuild() {
+        if (!job_ || !job_->done.load(std::memory_order_acquire)) return;
+        builder_.join();
+
+        // Bring the new tree up to date: whatever changed since the snapshot
+        // has its current state in tree_
+        DynamicBVH& next = job_->tree;
+        for (EntityID id : changedSinceSnapshot_) {
+            glm::vec3 min, max;
+            if (tree_.getBounds(id, min, max)) {
+                next.insert(id, min, max);
+            }
+            else {
+                next.remove(id);
+            }
+        }
+
+        tree_ = std::move(next);
+        changesSinceBuild_ = changedSinceSnapshot_.size();
+        changedSinceSnapshot_.clear();
+        job_.reset();
+    }
+
+    void SpatialIndex::cancelRebuild() {
+        if (builder_.joinable()) builder_.join();
+        job_.reset();
+        changedSinceSnapshot_.clear();
+    }
+
+} // namespace libre
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "DynamicBVH.h"
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace libre {
+
+    class World;
+
+    // ============================================================================
+    // SPATIAL INDEX - World bounds of every entity in a DynamicBVH
+    // ============================================================================
+    // sync() follows the BoundsComponent change log: removed bounds leave
+    // the tree, new ones are inserted, changed ones are refitted (one batch
+    // refit when many move at once). TransformSystem stamps the bounds it
+    // recomputes, so moved entities show up here as changes.
+    //
+    // Refits and incremental inserts slowly loosen the tree. Once enough of
+    // it has changed since the last build, a fresh SAH build of a snapshot
+    // starts on a thread of its own; the current tree keeps answering
+    // queries and keeps getting updated. When the build is done, a later
+    // sync() replays what changed since the snapshot onto the new tree and
+    // swaps it in. Small trees are rebuilt inline instead. (Not a pool
+    // task: a parallelFor caller helping out while it waits could pick the
+    // build up and stall the frame.)
+    //
+    // Call sync() at a sync point, after TransformSystem::update and
+    // World::flushDestroyed.
+
+    class SpatialIndex {
+    public:
+        SpatialIndex() = default;
+        ~SpatialIndex();
+
+        SpatialIndex(const SpatialIndex&) = delete;
+        SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+        // Apply bounds changes since the last sync. Returns the number of
+        // entities inserted, moved or removed.
+        size_t sync(World& world);
+
+        const DynamicBVH& getTree() const { return tree_; }
+
+        // Rebuild from scratch at the next sync (background for large trees)
+        void requestRebuild() { rebuildRequested_ = true; }
+        bool isRebuilding() const { return job_ != nullptr; }
+
+        // Drop everything; the next sync re-reads all bounds. Waits for a
+        // background build in flight.
+        void clear();
+
+        // Change tick this index has consumed up to (for trimChangeLogs)
+        uint32_t getSyncTick() const { return syncTick_; }
+
+    private:
+        // Rebuild once this many leaf changes accumulated, relative to the
+        // tree size (and at least MIN_REBUILD_CHANGES)
+        static constexpr float REBUILD_FRACTION = 0.25f;
+        static constexpr size_t MIN_REBUILD_CHANGES = 1024;
+
+        // Below this many leaves rebuilds run inline
+        static constexpr size_t BACKGROUND_THRESHOLD = 16384;
+
+        // A sync moving more than this fraction of the tree refits in one pass
+        static constexpr float BATCH_REFIT_FRACTION = 0.125f;
+
+        // Snapshot and result of a background build
+        struct RebuildJob {
+            std::vector<EntityID> entities;
+            std::vector<glm::vec3> mins;
+            std::vector<glm::vec3> maxs;
+            DynamicBVH tree;
+            std::atomic<bool> done{ false };
+        };
+
+        void applyChanges();
+        void maybeRebuild();
+        void startRebuild();
+        void finishRebuild();
+        void cancelRebuild();
+
+        DynamicBVH tree_;
+        uint32_t syncTick_ = 0;
+        bool fullSync_ = true;
+        bool rebuildRequested_ = false;
+        size_t changesSinceBuild_ = 0;
+
+        std::unique_ptr<RebuildJob> job_;
+        std::thread builder_;
+        std::vector<EntityID> changedSinceSnapshot_;
+
+        // Per-sync scratch, reused
+        std::vector<EntityID> removed_;
+        std::vector<EntityID> changed_;
+        std::vector<glm::vec3> changedMins_;
+        std::vector<glm::vec3> changedMaxs_;
+        std::vector<size_t> inserted_;      // Indices into changed_ not in the tree yet
+    };
+
+} // namespace libre
@@ -0,0 +1,321 @@
+#include "SystemScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace libre {
+
+    namespace {
+        template<typename T>
+        void insertSorted(std::vector<T>& values, const T& value) {
+            auto it = std::lower_bound(values.begin(), values.end(), value);
+            if (it == values.end() || *it != value) values.insert(it, value);
+        }
+
+        template<typename T>
+        bool sortedIntersect(const std::vector<T>& a, const std::vector<T>& b) {
+            auto i = a.begin();
+            auto j = b.begin();
+            while (i != a.end() && j != b.end()) {
+                if (*i < *j) ++i;
+                else if (*j < *i) ++j;
+                else return true;
+            }
+            return false;
+        }
+
+        double elapsedMs(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    // ============================================================================
+    // SYSTEM BUILDER
+    // ============================================================================
+
+    void SystemScheduler::SystemBuilder::addComponentAccess(ComponentTypeID type, bool write) {
+        System& system = scheduler_->systems_[index_];
+        insertSorted(write ? system.writes.components : system.reads.components, type);
+        scheduler_->graphDirty_ = true;
+    }
+
+    SystemScheduler::SystemBuilder& SystemScheduler::SystemBuilder::readsResource(const std::string& name) {
+        insertSorted(scheduler_->systems_[index_].reads.resources, name);
+        scheduler_->graphDirty_ = true;
+        return *this;
+    }
+
+    SystemScheduler::SystemBuilder& SystemScheduler::SystemBuilder::writesResource(const std::string& name) {
+        insertSorted(scheduler_->systems_[index_].writes.resources, name);
+        scheduler_->graphDirty_ = true;
+        return *this;
+    }
+
+    SystemScheduler::SystemBuilder& SystemScheduler::SystemBuilder::exclusive() {
+        scheduler_->systems_[index_].exclusive = true;
+        scheduler_->graphDirty_ = true;
+        return *this;
+    }
+
+    SystemScheduler::SystemBuilder& SystemScheduler::SystemBuilder::mainThread() {
+        scheduler_->systems_[index_].mainThread = true;
+        scheduler_->timings_[index_].mainThread = true;
+        return *this;
+    }
+
+    SystemScheduler::SystemBuilder& SystemScheduler::SystemBuilder::after(const std::string& name) {
+        scheduler_->systems_[index_].after.push_back(name);
+        scheduler_->graphDirty_ = true;
+        return *this;
+    }
+
+    SystemScheduler::SystemBuilder& SystemScheduler::SystemBuilder::before(const std::string& name) {
+        scheduler_->systems_[index_].before.push_back(name);
+        scheduler_->graphDirty_ = true;
+        return *this;
+    }
+
+    // ============================================================================
+    // SCHEDULER
+    // ============================================================================
+
+    bool SystemScheduler::AccessSet::intersects(const AccessSet& other) const {
+        return sortedIntersect(components, other.components) ||
+            sortedIntersect(resources, other.resources);
+    }
+
+    SystemScheduler::SystemScheduler(ThreadPool& pool) : pool_(pool) {}
+
+    SystemScheduler::~SystemScheduler() = default;
+
+    SystemScheduler::SystemBuilder SystemScheduler::addSystem(const std::string& name, SystemFunc func) {
+        System system;
+        system.name = name;
+        system.func = std::move(func);
+        systems_.push_back(std::move(system));
+
+        SystemTiming timing;
+        timing.name = name;
+        timings_.push_back(timing);
+
+        graphDirty_ = true;
+        return SystemBuilder(this, systems_.size() - 1);
+    }
+
+    void SystemScheduler::removeSystem(const std::string& name) {
+        int index = findSystem(name);
+        if (index < 0) return;
+
+        systems_.erase(systems_.begin() + index);
+        timings_.erase(timings_.begin() + index);
+        graphDirty_ = true;
+    }
+
+    bool SystemScheduler::hasSystem(const std::string& name) const {
+        return findSystem(name) >= 0;
+    }
+
+    int SystemScheduler::findSystem(const std::string& name) const {
+        for (size_t i = 0; i < systems_.size(); ++i) {
+            if (systems_[i].name == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    bool SystemScheduler::conflicts(const System& a, const System& b) const {
+        if (a.exclusive || b.exclusive) return true;
+        return a.writes.intersects(b.writes) ||
+            a.writes.intersects(b.reads) ||
+            b.writes.intersects(a.reads);
+    }
+
+    void SystemScheduler::buildGraph() {
+        size_t count = systems_.size();
+        std::vector<std::vector<bool>> edge(count, std::vector<bool>(count, false));
+        std::vector<std::vector<bool>> reach(count, std::vector<bool>(count, false));
+
+        // Add a -> b and keep 'reach' transitively closed
+        auto addEdge = [&](size_t a, size_t b) {
+            edge[a][b] = true;
+            for (size_t x = 0; x < count; ++x) {
+                if (x != a && !reach[x][a]) continue;
+                reach[x][b] = true;
+                for (size_t y = 0; y < count; ++y) {
+                    if (reach[b][y]) reach[x][y] = true;
+                }
+            }
+        };
+
+        // Explicit constraints first (unknown names are ignored so systems can
+        // be optional or registered in any order)
+        auto addConstraint = [&](size_t a, size_t b) {
+            if (a == b || edge[a][b]) return;
+            if (reach[b][a]) {
+                throw std::runtime_error("System ordering constraints form a cycle: " +
+                    systems_[a].name + " -> " + systems_[b].name);
+            }
+            addEdge(a, b);
+        };
+
+        for (size_t i = 0; i < count; ++i) {
+            for (const auto& name : systems_[i].after) {
+                int other = findSystem(name);
+                if (other >= 0) addConstraint(static_cast<size_t>(other), i);
+            }
+            for (const auto& name : systems_[i].before) {
+                int other = findSystem(name);
+                if (other >= 0) addConstraint(i, static_cast<size_t>(other));
+            }
+        }
+
+        // Data conflicts run in registration order unless a constraint
+        // already orders the pair the other way
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = i + 1; j < count; ++j) {
+                if (!conflicts(systems_[i], systems_[j])) continue;
+                if (reach[i][j] || reach[j][i]) continue;
+                addEdge(i, j);
+            }
+        }
+
+        successors_.assign(count, {});
+        predecessorCounts_.assign(count, 0);
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < count; ++j) {
+                if (!edge[i][j]) continue;
+                successors_[i].push_back(static_cast<uint32_t>(j));
+                ++predecessorCounts_[j];
+            }
+        }
+
+        graphDirty_ = false;
+    }
+
+    void SystemScheduler::run(World& world, float deltaTime) {
+        if (graphDirty_) {
+            buildGraph();
+        }
+
+        size_t count = systems_.size();
+        if (count == 0) return;
+
+        auto frameStart = std::chrono::steady_clock::now();
+
+        // Without workers everything runs here, in the same order
+        bool inlineAll = pool_.getWorkerCount() == 0;
+
+        std::vector<std::atomic<uint32_t>> remaining(count);
+        for (size_t i = 0; i < count; ++i) {
+            remaining[i].store(predecessorCounts_[i]);
+        }
+        std::vector<double> durations(count, 0.0);
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<uint32_t> mainReady;
+        size_t completed = 0;
+        std::exception_ptr error;
+
+        // Forward-declared so a finished system can release its successors
+        std::function<void(uint32_t)> dispatch;
+
+        auto execute = [&](uint32_t index) {
+            auto start = std::chrono::steady_clock::now();
+            try {
+                systems_[index].func(world, deltaTime);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+            durations[index] = elapsedMs(start);
+
+            for (uint32_t next : successors_[index]) {
+                if (remaining[next].fetch_sub(1) == 1) dispatch(next);
+            }
+
+            // Notify under the lock: once it is released, run() may return
+            // and destroy everything captured here
+            std::lock_guard<std::mutex> lock(mutex);
+            ++completed;
+            wake.notify_one();
+        };
+
+        dispatch = [&](uint32_t index) {
+            if (inlineAll || systems_[index].mainThread) {
+                std::lock_guard<std::mutex> lock(mutex);
+                mainReady.push_back(index);
+                wake.notify_one();
+            }
+            else {
+                pool_.submit([&execute, index] { execute(index); });
+            }
+        };
+
+        for (uint32_t i = 0; i < count; ++i) {
+            if (predecessorCounts_[i] == 0) dispatch(i);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (completed < count) {
+            if (!mainReady.empty()) {
+                // Lowest index first keeps inline execution in registration order
+                auto it = std::min_element(mainReady.begin(), mainReady.end());
+                uint32_t index = *it;
+                mainReady.erase(it);
+
+                lock.unlock();
+                execute(index);
+                lock.lock();
+                continue;
+            }
+
+            // Help the pool instead of idling
+            lock.unlock();
+            bool ranTask = pool_.runPendingTask();
+            lock.lock();
+            if (ranTask) continue;
+
+            wake.wait(lock, [&] { return !mainReady.empty() || completed == count; });
+        }
+        lock.unlock();
+
+        // Timings
+        for (size_t i = 0; i < count; ++i) {
+            SystemTiming& timing = timings_[i];
+            timing.lastMs = durations[i];
+            timing.avgMs = timing.runs == 0 ? durations[i] : timing.avgMs * 0.95 + durations[i] * 0.05;
+            timing.maxMs = std::max(timing.maxMs, durations[i]);
+            ++timing.runs;
+        }
+        lastFrameMs_ = elapsedMs(frameStart);
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::string SystemScheduler::getTimingReport() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "=== Systems (" << systems_.size() << ", last frame "
+            << lastFrameMs_ << " ms) ===\n";
+
+        for (const auto& timing : timings_) {
+            out << "  " << std::left << std::setw(20) << timing.name
+                << " last " << std::right << std::setw(8) << timing.lastMs
+                << " ms  avg " << std::setw(8) << timing.avgMs
+                << " ms  max " << std::setw(8) << timing.maxMs << " ms"
+                << (timing.mainThread ? "  [main]" : "") << "\n";
+        }
+        return out.str();
+    }
+
+} // namespace libre
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "../world/Types.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <cstdint>
+
+namespace libre {
+
+    class World;
+
+    // ============================================================================
+    // SYSTEM SCHEDULER - Runs per-frame systems by declared data access
+    // ============================================================================
+    // Each system declares the components (and named resources such as
+    // "Renderer" or "Input") it reads and writes. Two systems conflict when
+    // one writes something the other reads or writes, or when either is
+    // exclusive. Conflicting systems run in registration order unless
+    // after()/before() constraints order them the other way; only the
+    // explicit constraints can form a cycle. Everything else may run
+    // concurrently on the work-stealing pool, so results don't depend on
+    // thread timing.
+    //
+    // The dependency graph is rebuilt only when systems are added or removed.
+    // Main-thread systems (window, Vulkan) run on the thread that calls run().
+    //
+    //     scheduler.addSystem("transforms", fn)
+    //         .writes<TransformComponent, BoundsComponent>()
+    //         .after("editor");
+
+    class SystemScheduler {
+    public:
+        using SystemFunc = std::function<void(World& world, float deltaTime)>;
+
+        struct SystemTiming {
+            std::string name;
+            double lastMs = 0.0;
+            double avgMs = 0.0;       // Exponential moving average
+            double maxMs = 0.0;
+            uint64_t runs = 0;
+            bool mainThread = false;
+        };
+
+        class SystemBuilder {
+        public:
+            template<typename... Ts>
+            SystemBuilder& reads() {
+                (addComponent<Ts>(false), ...);
+                return *this;
+            }
+
+            template<typename... Ts>
+            SystemBuilder& writes() {
+                (addComponent<Ts>(true), ...);
+                return *this;
+            }
+
+            SystemBuilder& readsResource(const std::string& name);
+            SystemBuilder& writesResource(const std::string& name);
+
+            // Conflicts with every other system (structural changes, editor
+            // commands, anything that touches unknown data)
+            SystemBuilder& exclusive();
+
+            SystemBuilder& mainThread();
+            SystemBuilder& after(const std::string& name);
+            SystemBuilder& before(const std::string& name);
+
+        private:
+            friend class SystemScheduler;
+            SystemBuilder(SystemScheduler* scheduler, size_t index)
+                : scheduler_(scheduler), index_(index) {
+            }
+
+            template<typename T>
+            void addComponent(bool write) {
+                addComponentAccess(getComponentTypeID<T>(), write);
+            }
+
+            void addComponentAccess(ComponentTypeID type, bool write);
+
+            SystemScheduler* scheduler_;
+            size_t index_;
+        };
+
+        explicit SystemScheduler(ThreadPool& pool = ThreadPool::instance());
+        ~SystemScheduler();
+
+        SystemScheduler(const SystemScheduler&) = delete;
+        SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+        SystemBuilder addSystem(const std::string& name, SystemFunc func);
+        void removeSystem(const std::string& name);
+        bool hasSystem(const std::string& name) const;
+
+        // Run every system once. Blocks until all are done; the first
+        // exception thrown by a system is rethrown here.
+        // Throws std::runtime_error if ordering constraints form a cycle.
+        void run(World& world, float deltaTime);
+
+        const std::vector<SystemTiming>& getTimings() const { return timings_; }
+        double getLastFrameMs() const { return lastFrameMs_; }
+
+        // Human-readable per-system timing table
+        std::string getTimingReport() const;
+
+        size_t getSystemCount() const { return systems_.size(); }
+
+    private:
+        // Sorted, duplicate-free
+        struct AccessSet {
+            std::vector<ComponentTypeID> components;
+            std::vector<std::string> resources;
+
+            bool intersects(const AccessSet& other) const;
+        };
+
+        struct System {
+            std::string name;
+            SystemFunc func;
+            AccessSet reads;
+            AccessSet writes;
+            std::vector<std::string> after;
+            std::vector<std::string> before;
+            bool exclusive = false;
+            bool mainThread = false;
+        };
+
+        bool conflicts(const System& a, const System& b) const;
+        void buildGraph();
+        int findSystem(const std::string& name) const;
+
+        ThreadPool& pool_;
+        std::vector<System> systems_;
+        std::vector<SystemTiming> timings_;
+
+        // Dependency graph (valid while !graphDirty_)
+        std::vector<std::vector<uint32_t>> successors_;
+        std::vector<uint32_t> predecessorCounts_;
+        bool graphDirty_ = true;
+
+        double lastFrameMs_ = 0.0;
+    };
+
+} // namespace libre
@@ -0,0 +1,179 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+namespace libre {
+
+    namespace {
+        thread_local const ThreadPool* tlsPool = nullptr;
+        thread_local size_t tlsWorkerIndex = 0;
+    }
+
+    ThreadPool::ThreadPool(size_t threadCount) {
+        if (threadCount == 0) {
+            threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        size_t workerCount = threadCount - 1;
+        for (size_t i = 0; i <= workerCount; ++i) {
+            queues_.push_back(std::make_unique<WorkQueue>());
+        }
+
+        workers_.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    bool ThreadPool::isWorkerThread() const {
+        return tlsPool == this;
+    }
+
+    void ThreadPool::submit(Task task) {
+        size_t target = isWorkerThread() ? tlsWorkerIndex : queues_.size() - 1;
+        {
+            std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+
+        {
+            // Pairs with the predicate check in workerLoop (no lost wakeups)
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            queuedTasks_.fetch_add(1);
+        }
+        wake_.notify_one();
+    }
+
+    bool ThreadPool::popTask(size_t self, Task& task) {
+        size_t injection = queues_.size() - 1;
+
+        auto tryPop = [&](size_t index, bool back) {
+            WorkQueue& queue = *queues_[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) return false;
+
+            if (back) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queuedTasks_.fetch_sub(1);
+            return true;
+        };
+
+        if (self < injection && tryPop(self, true)) return true;
+        if (tryPop(injection, false)) return true;
+
+        for (size_t i = 0; i < injection; ++i) {
+            size_t victim = (self + 1 + i) % injection;
+            if (victim != self && tryPop(victim, false)) return true;
+        }
+        return false;
+    }
+
+    bool ThreadPool::runPendingTask() {
+        if (queuedTasks_.load() == 0) return false;
+
+        Task task;
+        size_t self = isWorkerThread() ? tlsWorkerIndex : queues_.size() - 1;
+        if (!popTask(self, task)) return false;
+
+        task();
+        return true;
+    }
+
+    void ThreadPool::workerLoop(size_t self) {
+        tlsPool = this;
+        tlsWorkerIndex = self;
+
+        for (;;) {
+            Task task;
+            if (popTask(self, task)) {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [&] { return stopping_ || queuedTasks_.load() > 0; });
+            if (stopping_) return;
+        }
+    }
+
+    void ThreadPool::parallelFor(size_t count, size_t grainSize, const RangeFunc& func) {
+        if (count == 0) return;
+        size_t grain = std::max<size_t>(1, grainSize);
+        size_t ranges = (count + grain - 1) / grain;
+
+        if (workers_.empty() || ranges == 1) {
+            func(0, count);
+            return;
+        }
+
+        // Shared so that helper tasks that start late can still touch it
+        struct Job {
+            const RangeFunc* func = nullptr;
+            size_t count = 0;
+            size_t grain = 1;
+            std::atomic<size_t> next{ 0 };
+            std::atomic<size_t> pending{ 0 };
+            std::mutex errorMutex;
+            std::exception_ptr error;
+
+            void run() {
+                for (;;) {
+                    size_t begin = next.fetch_add(grain);
+                    if (begin >= count) return;
+
+                    try {
+                        (*func)(begin, std::min(count, begin + grain));
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!error) error = std::current_exception();
+                    }
+                    pending.fetch_sub(1);
+                }
+            }
+        };
+
+        auto job = std::make_shared<Job>();
+        job->func = &func;
+        job->count = count;
+        job->grain = grain;
+        job->pending = ranges;
+
+        size_t helpers = std::min(workers_.size(), ranges - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            submit([job] { job->run(); });
+        }
+
+        job->run();
+
+        // Help with other work until the ranges claimed by helpers finish
+        while (job->pending.load() > 0) {
+            if (!runPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+
+        if (job->error) {
+            std::rethrow_exception(job->error);
+        }
+    }
+
+} // namespace libre
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // THREAD POOL - Work-stealing task pool with fork/join helpers
+    // ============================================================================
+    // Every worker owns a deque. Tasks submitted from a worker go to the back
+    // of its own deque and are popped LIFO (cache-warm); idle workers steal
+    // from the front of other deques. Tasks submitted from outside the pool go
+    // to a shared injection queue.
+    //
+    // parallelFor splits [0, count) into grain-sized ranges claimed from a
+    // shared atomic cursor by the caller and by helper tasks. While the caller
+    // waits for the last range it runs other queued tasks, so nested
+    // parallelFor calls cannot deadlock.
+
+    class ThreadPool {
+    public:
+        using Task = std::function<void()>;
+        using RangeFunc = std::function<void(size_t begin, size_t end)>;
+
+        // threadCount counts the calling thread too (0 = hardware concurrency)
+        explicit ThreadPool(size_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Queue a task. With no workers, tasks only run via runPendingTask().
+        void submit(Task task);
+
+        // Run one queued task on the calling thread; false if none was found
+        bool runPendingTask();
+
+        void parallelFor(size_t count, size_t grainSize, const RangeFunc& func);
+
+        // Workers plus the calling thread
+        size_t getThreadCount() const { return workers_.size() + 1; }
+        size_t getWorkerCount() const { return workers_.size(); }
+
+        // True on one of this pool's worker threads
+        bool isWorkerThread() const;
+
+        // Shared pool used by World::parallelForEach/parallelEach and the
+        // system scheduler
+        static ThreadPool& instance() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+    private:
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void workerLoop(size_t self);
+
+        // Own queue (back), then injection queue, then steal (front)
+        bool popTask(size_t self, Task& task);
+
+        std::vector<std::thread> workers_;
+        std::vector<std::unique_ptr<WorkQueue>> queues_;   // Per worker + injection queue last
+
+        std::atomic<size_t> queuedTasks_{ 0 };
+        std::mutex sleepMutex_;
+        std::condition_variable wake_;
+        bool stopping_ = false;
+    };
+
+} // namespace libre
@@ -0,0 +1,374 @@
+#include "TransformKernels.h"
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LIBRE_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define LIBRE_TARGET(features)
+#define LIBRE_FORCE_INLINE __forceinline
+#else
+#define LIBRE_TARGET(features) __attribute__((target(features)))
+#define LIBRE_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+#else
+#define LIBRE_KERNELS_X86 0
+#endif
+
+namespace libre {
+
+    namespace {
+
+        // ========================================================================
+        // SCALAR
+        // ========================================================================
+
+        void composeScalar(const TRSArrays& a, const Affine3x4* const* parents, size_t begin, size_t end, Affine3x4* out) {
+            for (size_t i = begin; i < end; ++i) {
+                float x2 = a.qx[i] + a.qx[i], y2 = a.qy[i] + a.qy[i], z2 = a.qz[i] + a.qz[i];
+                float xx = a.qx[i] * x2, yy = a.qy[i] * y2, zz = a.qz[i] * z2;
+                float xy = a.qx[i] * y2, xz = a.qx[i] * z2, yz = a.qy[i] * z2;
+                float wx = a.qw[i] * x2, wy = a.qw[i] * y2, wz = a.qw[i] * z2;
+
+                Affine3x4 local;
+                local.rows[0] = glm::vec4((1.0f - (yy + zz)) * a.sx[i], (xy - wz) * a.sy[i], (xz + wy) * a.sz[i], a.px[i]);
+                local.rows[1] = glm::vec4((xy + wz) * a.sx[i], (1.0f - (xx + zz)) * a.sy[i], (yz - wx) * a.sz[i], a.py[i]);
+                local.rows[2] = glm::vec4((xz - wy) * a.sx[i], (yz + wx) * a.sy[i], (1.0f - (xx + yy)) * a.sz[i], a.pz[i]);
+
+                const Affine3x4* parent = parents ? parents[i] : nullptr;
+                out[i] = parent ? *parent * local : local;
+            }
+        }
+
+        void transformAABBsScalar(const Affine3x4* m, const glm::vec3* localMin, const glm::vec3* localMax,
+            size_t begin, size_t end, glm::vec3* worldMin, glm::vec3* worldMax) {
+            for (size_t i = begin; i < end; ++i) {
+                glm::vec3 center = (localMin[i] + localMax[i]) * 0.5f;
+                glm::vec3 extent = (localMax[i] - localMin[i]) * 0.5f;
+
+                glm::vec3 c = m[i].transformPoint(center);
+                glm::vec3 e;
+                for (int r = 0; r < 3; ++r) {
+                    e[r] = glm::dot(glm::abs(glm::vec3(m[i].rows[r])), extent);
+                }
+                worldMin[i] = c - e;
+                worldMax[i] = c + e;
+            }
+        }
+
+#if LIBRE_KERNELS_X86
+
+        // ========================================================================
+        // SSE4.1
+        // ========================================================================
+
+        // Twelve rotation-scale and translation lanes for 4 transforms ->
+        // 4 affine matrices, parent applied, stored to out[0..3].
+        // Always inlined so the AVX2 caller gets VEX encoding throughout
+        // (mixing in legacy SSE code costs a state transition per call).
+        LIBRE_TARGET("sse4.1")
+        LIBRE_FORCE_INLINE void storeAffine4(const __m128* m, const Affine3x4* const* parents, Affine3x4* out) {
+            // One transpose per row: lanes are transforms, m[] holds columns
+            __m128 rows[4][3];
+            for (int r = 0; r < 3; ++r) {
+                __m128 r0 = m[r], r1 = m[3 + r], r2 = m[6 + r], r3 = m[9 + r];
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                rows[0][r] = r0;
+                rows[1][r] = r1;
+                rows[2][r] = r2;
+                rows[3][r] = r3;
+            }
+
+            for (int k = 0; k < 4; ++k) {
+                float* dst = &out[k].rows[0][0];
+                const Affine3x4* parent = parents ? parents[k] : nullptr;
+                if (!parent) {
+                    for (int r = 0; r < 3; ++r) _mm_storeu_ps(dst + r * 4, rows[k][r]);
+                    continue;
+                }
+
+                // world row = P row . local rows, plus P's translation
+                const float* p = &parent->rows[0][0];
+                for (int r = 0; r < 3; ++r) {
+                    __m128 pr = _mm_loadu_ps(p + r * 4);
+                    __m128 w = _mm_blend_ps(_mm_setzero_ps(), pr, 0x8);
+                    w = _mm_add_ps(w, _mm_mul_ps(rows[k][0], _mm_shuffle_ps(pr, pr, _MM_SHUFFLE(0, 0, 0, 0))));
+                    w = _mm_add_ps(w, _mm_mul_ps(rows[k][1], _mm_shuffle_ps(pr, pr, _MM_SHUFFLE(1, 1, 1, 1))));
+                    w = _mm_add_ps(w, _mm_mul_ps(rows[k][2], _mm_shuffle_ps(pr, pr, _MM_SHUFFLE(2, 2, 2, 2))));
+                    _mm_storeu_ps(dst + r * 4, w);
+                }
+            }
+        }
+
+        LIBRE_TARGET("sse4.1")
+        size_t composeSSE41(const TRSArrays& a, const Affine3x4* const* parents, size_t count, Affine3x4* out) {
+            __m128 one = _mm_set1_ps(1.0f);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128 qx = _mm_loadu_ps(a.qx + i), qy = _mm_loadu_ps(a.qy + i);
+                __m128 qz = _mm_loadu_ps(a.qz + i), qw = _mm_loadu_ps(a.qw + i);
+                __m128 sx = _mm_loadu_ps(a.sx + i), sy = _mm_loadu_ps(a.sy + i), sz = _mm_loadu_ps(a.sz + i);
+
+                __m128 x2 = _mm_add_ps(qx, qx), y2 = _mm_add_ps(qy, qy), z2 = _mm_add_ps(qz, qz);
+                __m128 xx = _mm_mul_ps(qx, x2), yy = _mm_mul_ps(qy, y2), zz = _mm_mul_ps(qz, z2);
+                __m128 xy = _mm_mul_ps(qx, y2), xz = _mm_mul_ps(qx, z2), yz = _mm_mul_ps(qy, z2);
+                __m128 wx = _mm_mul_ps(qw, x2), wy = _mm_mul_ps(qw, y2), wz = _mm_mul_ps(qw, z2);
+
+                __m128 m[12] = {
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+                    _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+                    _mm_mul_ps(_mm_sub_ps(xz, wy), sx),
+                    _mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+                    _mm_mul_ps(_mm_add_ps(yz, wx), sy),
+                    _mm_mul_ps(_mm_add_ps(xz, wy), sz),
+                    _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+                    _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz),
+                    _mm_loadu_ps(a.px + i),
+                    _mm_loadu_ps(a.py + i),
+                    _mm_loadu_ps(a.pz + i),
+                };
+                storeAffine4(m, parents ? parents + i : nullptr, out + i);
+            }
+            return i;
+        }
+
+        LIBRE_TARGET("sse4.1")
+        inline void arvo4(const Affine3x4& matrix, const glm::vec3& lo, const glm::vec3& hi, glm::vec3& outMin, glm::vec3& outMax) {
+            __m128 half = _mm_set1_ps(0.5f);
+            __m128 signMask = _mm_set1_ps(-0.0f);
+            __m128 mn = _mm_set_ps(0.0f, lo.z, lo.y, lo.x);
+            __m128 mx = _mm_set_ps(0.0f, hi.z, hi.y, hi.x);
+            __m128 center = _mm_mul_ps(_mm_add_ps(mn, mx), half);
+            __m128 extent = _mm_mul_ps(_mm_sub_ps(mx, mn), half);
+
+            // Rows -> columns (translation last), center/extent in lanes 0..2
+            const float* p = &matrix.rows[0][0];
+            __m128 m0 = _mm_loadu_ps(p), m1 = _mm_loadu_ps(p + 4), m2 = _mm_loadu_ps(p + 8), m3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(m0, m1, m2, m3);
+
+            __m128 c = _mm_add_ps(m3, _mm_mul_ps(m0, _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0))));
+            c = _mm_add_ps(c, _mm_mul_ps(m1, _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1))));
+            c = _mm_add_ps(c, _mm_mul_ps(m2, _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2))));
+
+            __m128 e = _mm_mul_ps(_mm_andnot_ps(signMask, m0), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0)));
+            e = _mm_add_ps(e, _mm_mul_ps(_mm_andnot_ps(signMask, m1), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1))));
+            e = _mm_add_ps(e, _mm_mul_ps(_mm_andnot_ps(signMask, m2), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2))));
+
+            alignas(16) float lower[4];
+            alignas(16) float upper[4];
+            _mm_store_ps(lower, _mm_sub_ps(c, e));
+            _mm_store_ps(upper, _mm_add_ps(c, e));
+            outMin = glm::vec3(lower[0], lower[1], lower[2]);
+            outMax = glm::vec3(upper[0], upper[1], upper[2]);
+        }
+
+        LIBRE_TARGET("sse4.1")
+        size_t transformAABBsSSE41(const Affine3x4* m, const glm::vec3* localMin, const glm::vec3* localMax,
+            size_t count, glm::vec3* worldMin, glm::vec3* worldMax) {
+            for (size_t i = 0; i < count; ++i) {
+                arvo4(m[i], localMin[i], localMax[i], worldMin[i], worldMax[i]);
+            }
+            return count;
+        }
+
+        // ========================================================================
+        // AVX2
+        // ========================================================================
+
+        LIBRE_TARGET("avx2,fma")
+        size_t composeAVX2(const TRSArrays& a, const Affine3x4* const* parents, size_t count, Affine3x4* out) {
+            __m256 one = _mm256_set1_ps(1.0f);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 qx = _mm256_loadu_ps(a.qx + i), qy = _mm256_loadu_ps(a.qy + i);
+                __m256 qz = _mm256_loadu_ps(a.qz + i), qw = _mm256_loadu_ps(a.qw + i);
+                __m256 sx = _mm256_loadu_ps(a.sx + i), sy = _mm256_loadu_ps(a.sy + i), sz = _mm256_loadu_ps(a.sz + i);
+
+                __m256 x2 = _mm256_add_ps(qx, qx), y2 = _mm256_add_ps(qy, qy), z2 = _mm256_add_ps(qz, qz);
+                __m256 xx = _mm256_mul_ps(qx, x2), yy = _mm256_mul_ps(qy, y2), zz = _mm256_mul_ps(qz, z2);
+                __m256 xy = _mm256_mul_ps(qx, y2), xz = _mm256_mul_ps(qx, z2), yz = _mm256_mul_ps(qy, z2);
+                __m256 wx = _mm256_mul_ps(qw, x2), wy = _mm256_mul_ps(qw, y2), wz = _mm256_mul_ps(qw, z2);
+
+                __m256 m[12] = {
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+                    _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+                    _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx),
+                    _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+                    _mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+                    _mm256_mul_ps(_mm256_add_ps(xz, wy), sz),
+                    _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+                    _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+                    _mm256_loadu_ps(a.px + i),
+                    _mm256_loadu_ps(a.py + i),
+                    _mm256_loadu_ps(a.pz + i),
+                };
+
+                // Two groups of four for the transposes
+                __m128 low[12];
+                __m128 high[12];
+                for (int k = 0; k < 12; ++k) {
+                    low[k] = _mm256_castps256_ps128(m[k]);
+                    high[k] = _mm256_extractf128_ps(m[k], 1);
+                }
+                storeAffine4(low, parents ? parents + i : nullptr, out + i);
+                storeAffine4(high, parents ? parents + i + 4 : nullptr, out + i + 4);
+            }
+            return i;
+        }
+
+        LIBRE_TARGET("avx2,fma")
+        LIBRE_FORCE_INLINE __m256 pair(const float* a, const float* b) {
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(a)), _mm_loadu_ps(b), 1);
+        }
+
+        // Two boxes per step, one per 128-bit half
+        LIBRE_TARGET("avx2,fma")
+        size_t transformAABBsAVX2(const Affine3x4* m, const glm::vec3* localMin, const glm::vec3* localMax,
+            size_t count, glm::vec3* worldMin, glm::vec3* worldMax) {
+            __m256 half = _mm256_set1_ps(0.5f);
+            __m256 signMask = _mm256_set1_ps(-0.0f);
+
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                __m256 mn = _mm256_set_ps(0.0f, localMin[i + 1].z, localMin[i + 1].y, localMin[i + 1].x,
+                    0.0f, localMin[i].z, localMin[i].y, localMin[i].x);
+                __m256 mx = _mm256_set_ps(0.0f, localMax[i + 1].z, localMax[i + 1].y, localMax[i + 1].x,
+                    0.0f, localMax[i].z, localMax[i].y, localMax[i].x);
+                __m256 center = _mm256_mul_ps(_mm256_add_ps(mn, mx), half);
+                __m256 extent = _mm256_mul_ps(_mm256_sub_ps(mx, mn), half);
+
+                // Rows -> columns; unpack and shuffle stay within each half
+                const float* a = &m[i].rows[0][0];
+                const float* b = &m[i + 1].rows[0][0];
+                __m256 r0 = pair(a, b), r1 = pair(a + 4, b + 4), r2 = pair(a + 8, b + 8);
+                __m256 r3 = _mm256_setzero_ps();
+                __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpacklo_ps(r2, r3);
+                __m256 t2 = _mm256_unpackhi_ps(r0, r1), t3 = _mm256_unpackhi_ps(r2, r3);
+                __m256 m0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+                __m256 m1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+                __m256 m2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+                __m256 m3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+                // Lane broadcasts stay within each half, i.e. per box
+                __m256 c = _mm256_fmadd_ps(m0, _mm256_permute_ps(center, 0x00), m3);
+                c = _mm256_fmadd_ps(m1, _mm256_permute_ps(center, 0x55), c);
+                c = _mm256_fmadd_ps(m2, _mm256_permute_ps(center, 0xAA), c);
+
+                __m256 e = _mm256_mul_ps(_mm256_andnot_ps(signMask, m0), _mm256_permute_ps(extent, 0x00));
+                e = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m1), _mm256_permute_ps(extent, 0x55), e);
+                e = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m2), _mm256_permute_ps(extent, 0xAA), e);
+
+                alignas(32) float lower[8];
+                alignas(32) float upper[8];
+                _mm256_store_ps(lower, _mm256_sub_ps(c, e));
+                _mm256_store_ps(upper, _mm256_add_ps(c, e));
+                worldMin[i] = glm::vec3(lower[0], lower[1], lower[2]);
+                worldMax[i] = glm::vec3(upper[0], upper[1], upper[2]);
+                worldMin[i + 1] = glm::vec3(lower[4], lower[5], lower[6]);
+                worldMax[i + 1] = glm::vec3(upper[4], upper[5], upper[6]);
+            }
+            return i;
+        }
+
+#endif // LIBRE_KERNELS_X86
+
+        SimdLevel detectLevel() {
+#if LIBRE_KERNELS_X86
+            bool sse41 = false;
+            bool avx2 = false;
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            int maxLeaf = info[0];
+            __cpuid(info, 1);
+            sse41 = (info[2] & (1 << 19)) != 0;
+            bool fma = (info[2] & (1 << 12)) != 0;
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+
+            // The OS must save YMM state too
+            if (maxLeaf >= 7 && fma && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            sse41 = __builtin_cpu_supports("sse4.1");
+            avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+            if (avx2) return SimdLevel::AVX2;
+            if (sse41) return SimdLevel::SSE41;
+#endif
+            return SimdLevel::Scalar;
+        }
+
+        SimdLevel supportedLevel() {
+            static const SimdLevel level = detectLevel();
+            return level;
+        }
+
+        std::atomic<SimdLevel>& activeLevel() {
+            static std::atomic<SimdLevel> level{ supportedLevel() };
+            return level;
+        }
+
+    } // namespace
+
+    // ============================================================================
+    // DISPATCH
+    // ============================================================================
+
+    void TransformKernels::composeTRS(const TRSArrays& trs, const Affine3x4* const* parents, size_t count, Affine3x4* out) {
+        size_t done = 0;
+#if LIBRE_KERNELS_X86
+        switch (getLevel()) {
+        case SimdLevel::AVX2: done = composeAVX2(trs, parents, count, out); break;
+        case SimdLevel::SSE41: done = composeSSE41(trs, parents, count, out); break;
+        default: break;
+        }
+#endif
+        // Remainder (and the scalar level)
+        composeScalar(trs, parents, done, count, out);
+    }
+
+    void TransformKernels::transformAABBs(const Affine3x4* matrices, const glm::vec3* localMin, const glm::vec3* localMax,
+        size_t count, glm::vec3* worldMin, glm::vec3* worldMax) {
+        size_t done = 0;
+#if LIBRE_KERNELS_X86
+        switch (getLevel()) {
+        case SimdLevel::AVX2: done = transformAABBsAVX2(matrices, localMin, localMax, count, worldMin, worldMax); break;
+        case SimdLevel::SSE41: done = transformAABBsSSE41(matrices, localMin, localMax, count, worldMin, worldMax); break;
+        default: break;
+        }
+#endif
+        transformAABBsScalar(matrices, localMin, localMax, done, count, worldMin, worldMax);
+    }
+
+    SimdLevel TransformKernels::getLevel() {
+        return activeLevel().load(std::memory_order_relaxed);
+    }
+
+    SimdLevel TransformKernels::getSupportedLevel() {
+        return supportedLevel();
+    }
+
+    void TransformKernels::setLevel(SimdLevel level) {
+        if (level > supportedLevel()) level = supportedLevel();
+        activeLevel().store(level, std::memory_order_relaxed);
+    }
+
+    const char* TransformKernels::getLevelName(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE41: return "SSE4.1";
+        default: return "Scalar";
+        }
+    }
+
+} // namespace libre
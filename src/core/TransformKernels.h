@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Affine3x4.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libre {
+
+    enum class SimdLevel : uint8_t {
+        Scalar,
+        SSE41,
+        AVX2,       // With FMA
+    };
+
+    // Structure-of-arrays TRS input: element i of every array is one transform
+    struct TRSArrays {
+        const float* px;
+        const float* py;
+        const float* pz;
+        const float* qx;        // Unit quaternion
+        const float* qy;
+        const float* qz;
+        const float* qw;
+        const float* sx;
+        const float* sy;
+        const float* sz;
+    };
+
+    // ============================================================================
+    // TRANSFORM KERNELS - Batched world matrix and bounds math
+    // ============================================================================
+    // composeTRS() builds T * R * S straight from the quaternion (no
+    // intermediate matrices or matrix products) for 4 (SSE4.1) or 8 (AVX2)
+    // transforms per step, then applies the parent matrix if there is one.
+    // transformAABBs() uses Arvo's method: the world box of a local box is
+    // center' = M * center, extent' = |M3x3| * extent, which needs no corner
+    // transforms at all.
+    //
+    // The widest level the CPU supports is picked on first use; setLevel()
+    // lowers it (comparisons, benchmarks). Results match the scalar path to
+    // float rounding. Input and output arrays must not overlap.
+
+    class TransformKernels {
+    public:
+        // out[i] = parents[i] * TRS(i), or TRS(i) where parents (or
+        // parents[i]) is null
+        static void composeTRS(const TRSArrays& trs, const Affine3x4* const* parents, size_t count, Affine3x4* out);
+
+        // World AABBs of local boxes under affine matrices
+        static void transformAABBs(const Affine3x4* matrices, const glm::vec3* localMin, const glm::vec3* localMax,
+            size_t count, glm::vec3* worldMin, glm::vec3* worldMax);
+
+        static SimdLevel getLevel();
+        static SimdLevel getSupportedLevel();
+
+        // Clamped to what the CPU supports. Not thread-safe against running
+        // kernels; call at startup or between frames.
+        static void setLevel(SimdLevel level);
+
+        static const char* getLevelName(SimdLevel level);
+    };
+
+} // namespace libre
@@ -0,0 +1,179 @@
+#include "TransformSystem.h"
+#include "TransformKernels.h"
+#include "../world/World.h"
+#include "../components/CoreComponents.h"
+#include <algorithm>
+
+namespace libre {
+
+    size_t TransformSystem::update(World& world) {
+        world.advanceChangeTick();
+
+        collectSeeds(world);
+        collectSubtrees(world);
+        bucketByDepth();
+
+        const HierarchyStore& hierarchy = world.getHierarchy();
+        auto computeRange = [&](size_t begin, size_t end) {
+            // Gathered into SoA batches for TransformKernels; stack scratch,
+            // so ranges on different workers don't share anything
+            float trs[10][BATCH_SIZE];
+            const Affine3x4* parents[BATCH_SIZE];
+            TransformComponent* transforms[BATCH_SIZE];
+            Affine3x4 matrices[BATCH_SIZE];
+            BoundsComponent* bounds[BATCH_SIZE];
+            Affine3x4 boundsMatrix[BATCH_SIZE];
+            glm::vec3 localMin[BATCH_SIZE], localMax[BATCH_SIZE];
+            glm::vec3 worldMin[BATCH_SIZE], worldMax[BATCH_SIZE];
+            const TRSArrays arrays = { trs[0], trs[1], trs[2], trs[3], trs[4], trs[5], trs[6], trs[7], trs[8], trs[9] };
+
+            size_t i = begin;
+            while (i < end) {
+                size_t count = 0;
+                for (; i < end && count < BATCH_SIZE; ++i) {
+                    EntityID id = byLevel_[i];
+                    auto* transform = world.getComponent<TransformComponent>(id);
+                    if (!transform) continue;
+
+                    // Nearest ancestor with a transform; it sits on an earlier level
+                    const TransformComponent* parent = nullptr;
+                    for (EntityID p = hierarchy.getParent(id); p != INVALID_ENTITY && !parent; p = hierarchy.getParent(p)) {
+                        parent = world.getComponent<TransformComponent>(p);
+                    }
+
+                    trs[0][count] = transform->position.x;
+                    trs[1][count] = transform->position.y;
+                    trs[2][count] = transform->position.z;
+                    trs[3][count] = transform->rotation.x;
+                    trs[4][count] = transform->rotation.y;
+                    trs[5][count] = transform->rotation.z;
+                    trs[6][count] = transform->rotation.w;
+                    trs[7][count] = transform->scale.x;
+                    trs[8][count] = transform->scale.y;
+                    trs[9][count] = transform->scale.z;
+                    parents[count] = parent ? &parent->worldMatrix : nullptr;
+                    transforms[count] = transform;
+                    bounds[count] = world.getComponent<BoundsComponent>(id);
+                    ++count;
+                }
+
+                TransformKernels::composeTRS(arrays, parents, count, matrices);
+
+                size_t boundsCount = 0;
+                for (size_t j = 0; j < count; ++j) {
+                    transforms[j]->worldMatrix = matrices[j];
+                    if (bounds[j]) {
+                        boundsMatrix[boundsCount] = matrices[j];
+                        localMin[boundsCount] = bounds[j]->localMin;
+                        localMax[boundsCount] = bounds[j]->localMax;
+                        bounds[boundsCount] = bounds[j];
+                        ++boundsCount;
+                    }
+                }
+
+                TransformKernels::transformAABBs(boundsMatrix, localMin, localMax, boundsCount, worldMin, worldMax);
+                for (size_t j = 0; j < boundsCount; ++j) {
+                    bounds[j]->setWorldBounds(worldMin[j], worldMax[j]);
+                }
+            }
+        };
+
+        // A level only reads the levels above it
+        for (size_t level = 0; level + 1 < levelOffsets_.size(); ++level) {
+            size_t begin = levelOffsets_[level];
+            size_t count = levelOffsets_[level + 1] - begin;
+            if (count >= PARALLEL_THRESHOLD) {
+                pool_.parallelFor(count, GRAIN_SIZE, [&](size_t first, size_t last) {
+                    computeRange(begin + first, begin + last);
+                    });
+            }
+            else {
+                computeRange(begin, begin + count);
+            }
+        }
+
+        // Bounds whose local box was edited without moving the entity
+        world.changed<BoundsComponent>(syncTick_, [&](EntityID id, BoundsComponent& bounds) {
+            uint32_t index = getEntityIndex(id);
+            if (index < visited_.size() && visited_[index]) return;
+            if (auto* transform = world.getComponent<TransformComponent>(id)) {
+                bounds.updateWorldBounds(transform->worldMatrix);
+            }
+            });
+
+        // Stamp the recomputed bounds for other consumers (SpatialIndex).
+        // The tick they land in is closed right after, and this system reads
+        // changes from the next one on, so it won't take them for edits.
+        for (EntityID id : dirty_) {
+            visited_[getEntityIndex(id)] = 0;
+            world.markChanged<BoundsComponent>(id);
+        }
+
+        syncTick_ = world.advanceChangeTick();
+        fullUpdate_ = false;
+        return dirty_.size();
+    }
+
+    void TransformSystem::collectSeeds(World& world) {
+        const HierarchyStore& hierarchy = world.getHierarchy();
+        seeds_.clear();
+
+        if (fullUpdate_) {
+            seeds_.assign(hierarchy.getRoots().begin(), hierarchy.getRoots().end());
+        }
+
+        // Transforms written since the last update. World::setParent marks
+        // the moved transforms changed, so reparenting shows up here too.
+        world.changed<TransformComponent>(syncTick_, [&](EntityID id, TransformComponent&) {
+            seeds_.push_back(id);
+        });
+    }
+
+    void TransformSystem::collectSubtrees(World& world) {
+        dirty_.clear();
+        depths_.clear();
+
+        // A visited entity's subtree has been collected already, so the
+        // walk prunes there; overlapping seeds cost nothing extra
+        HierarchyWalker walk(world.getHierarchy());
+        for (EntityID root : seeds_) {
+            for (EntityID id : walk.depthFirst(root)) {
+                uint32_t index = getEntityIndex(id);
+                if (index >= visited_.size()) {
+                    visited_.resize(static_cast<size_t>(index) + 1, 0);
+                }
+                if (visited_[index]) {
+                    walk.skipChildren();
+                    continue;
+                }
+
+                visited_[index] = 1;
+                dirty_.push_back(id);
+                depths_.push_back(walk.depth());
+            }
+        }
+    }
+
+    void TransformSystem::bucketByDepth() {
+        // Counting sort; depths are dense from 0
+        uint32_t levels = 0;
+        for (uint32_t depth : depths_) levels = std::max(levels, depth + 1);
+
+        levelOffsets_.assign(static_cast<size_t>(levels) + 1, 0);
+        for (uint32_t depth : depths_) ++levelOffsets_[depth + 1];
+        for (uint32_t level = 0; level < levels; ++level) {
+            levelOffsets_[level + 1] += levelOffsets_[level];
+        }
+
+        // levelOffsets_ doubles as the fill cursor, then is shifted back
+        byLevel_.resize(dirty_.size());
+        for (size_t i = 0; i < dirty_.size(); ++i) {
+            byLevel_[levelOffsets_[depths_[i]]++] = dirty_[i];
+        }
+        for (uint32_t level = levels; level > 0; --level) {
+            levelOffsets_[level] = levelOffsets_[level - 1];
+        }
+        levelOffsets_[0] = 0;
+    }
+
+} // namespace libre
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "../world/Types.h"
+#include <vector>
+#include <cstdint>
+
+namespace libre {
+
+    class World;
+
+    // ============================================================================
+    // TRANSFORM SYSTEM - Hierarchical world matrix propagation
+    // ============================================================================
+    // A transform is dirty when it was written since the last update
+    // (World::changed; World::setParent marks moved transforms changed too).
+    // Dirtiness spreads to the whole subtree below: each dirty entity's
+    // descendants are collected with a pruned HierarchyWalker, so
+    // overlapping subtrees are visited once. The collected entities are
+    // bucketed by hierarchy depth (the store keeps depths current), and each
+    // depth level is computed in parallel, parents strictly before children.
+    // Cost scales with the dirty subtrees, not the scene; the very first
+    // update treats everything as dirty, so frame one is correct.
+    //
+    // Entities without a TransformComponent are transparent: their children
+    // attach to the nearest ancestor that has one. World bounds follow the
+    // recomputed matrices (and are marked changed, so SpatialIndex sees
+    // moves), and bounds edited on their own are refreshed too.
+    // The math itself runs in SIMD batches (TransformKernels).
+
+    class TransformSystem {
+    public:
+        explicit TransformSystem(ThreadPool& pool = ThreadPool::instance()) : pool_(pool) {}
+
+        // Recompute stale world and normal matrices and bounds. Returns the
+        // number of entities in dirty subtrees. Reads the hierarchy, writes
+        // Transform and Bounds components.
+        size_t update(World& world);
+
+        // Recompute everything at the next update (scene load, world clear)
+        void invalidate() { fullUpdate_ = true; }
+
+        // Change tick this system has consumed up to (for trimChangeLogs)
+        uint32_t getSyncTick() const { return syncTick_; }
+
+    private:
+        // Below this many entities a level is computed inline
+        static constexpr size_t PARALLEL_THRESHOLD = 512;
+        static constexpr size_t GRAIN_SIZE = 128;
+        // Entities gathered per TransformKernels call
+        static constexpr size_t BATCH_SIZE = 64;
+
+        void collectSeeds(World& world);
+        void collectSubtrees(World& world);
+        void bucketByDepth();
+
+        ThreadPool& pool_;
+        uint32_t syncTick_ = 0;
+        bool fullUpdate_ = true;
+
+        // Per-update scratch, reused
+        std::vector<EntityID> seeds_;
+        std::vector<uint8_t> visited_;      // By entity index; cleared after each update
+        std::vector<EntityID> dirty_;       // Seeds and their subtrees
+        std::vector<uint32_t> depths_;      // Parallel to dirty_
+        std::vector<uint32_t> levelOffsets_;
+        std::vector<EntityID> byLevel_;
+    };
+
+} // namespace libre
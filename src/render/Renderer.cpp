@@ -112,7 +112,7 @@ void Renderer::createSceneObjects() {
     std::cout << "[OK] Scene objects created" << std::endl;
 }
 
-void Renderer::submitMesh(Mesh* mesh, const glm::mat4& transform, const glm::vec3& color, bool selected) {
+void Renderer::submitMesh(Mesh* mesh, const libre::Affine3x4& transform, const glm::vec3& color, bool selected) {
     RenderObject obj;
     obj.mesh = mesh;
     obj.transform = transform;
@@ -143,6 +143,11 @@ Mesh* Renderer::getOrCreateMesh(uint64_t entityId, const void* vertexData, size_
     return mesh;
 }
 
+Mesh* Renderer::findMesh(uint64_t entityId) const {
+    auto it = meshCache.find(entityId);
+    return it != meshCache.end() ? it->second : nullptr;
+}
+
 void Renderer::removeMesh(uint64_t entityId) {
     auto it = meshCache.find(entityId);
     if (it != meshCache.end()) {
@@ -348,7 +353,7 @@ void Renderer::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t image
         pipeline->getGridPipelineLayout(), 0, 1, &descriptorSet, 0, nullptr);
 
     PushConstants gridPush{};
-    gridPush.model = glm::mat4(1.0f);
+    gridPush.model = libre::Affine3x4();
     vkCmdPushConstants(commandBuffer, pipeline->getGridPipelineLayout(),
         VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &gridPush);
 
@@ -7,6 +7,8 @@
 #include <unordered_map>
 #include <cstdint>
 
+#include "../core/Affine3x4.h"
+
 // Forward declarations
 class VulkanContext;
 class SwapChain;
@@ -18,7 +20,7 @@ class Camera;
 
 struct RenderObject {
     Mesh* mesh = nullptr;
-    glm::mat4 transform = glm::mat4(1.0f);
+    libre::Affine3x4 transform;
     glm::vec3 color = glm::vec3(0.8f);
     bool selected = false;
 };
@@ -39,12 +41,13 @@ public:
     // Called after swap chain is recreated
     void onSwapChainRecreated(SwapChain* newSwapChain);
 
-    void submitMesh(Mesh* mesh, const glm::mat4& transform,
+    void submitMesh(Mesh* mesh, const libre::Affine3x4& transform,
         const glm::vec3& color = glm::vec3(0.8f), bool selected = false);
     void clearSubmissions();
 
     Mesh* getOrCreateMesh(uint64_t entityId, const void* vertexData, size_t vertexCount,
         const uint32_t* indexData, size_t indexCount);
+    Mesh* findMesh(uint64_t entityId) const;
     void removeMesh(uint64_t entityId);
 
     Grid* getGrid() { return grid; }
@@ -5,6 +5,8 @@
 #include <glm/glm.hpp>
 #include <vector>
 
+#include "../core/Affine3x4.h"
+
 class VulkanContext;
 
 // Scene-wide uniform data (constant for entire frame)
@@ -17,9 +19,11 @@ struct UniformBufferObject {
     alignas(4)  float _pad2;
 };
 
-// Per-object data sent via push constants
+// Per-object data sent via push constants (48 bytes): the shaders' mat3x4
+// model. Normals are transformed with the model's cofactors in the vertex
+// shader rather than a second matrix here.
 struct PushConstants {
-    glm::mat4 model;
+    libre::Affine3x4 model;
 };
 
 class UniformBuffer {
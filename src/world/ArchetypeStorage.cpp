@@ -0,0 +1,362 @@
+#include "ArchetypeStorage.h"
+#include <algorithm>
+#include <cassert>
+
+namespace libre {
+
+    // ============================================================================
+    // ARCHETYPE
+    // ============================================================================
+
+    Archetype::Archetype(std::vector<const ComponentTypeInfo*> types)
+        : types_(std::move(types)) {
+        std::sort(types_.begin(), types_.end(),
+            [](const ComponentTypeInfo* a, const ComponentTypeInfo* b) { return a->id < b->id; });
+
+        typeIds_.reserve(types_.size());
+        for (const auto* info : types_) {
+            typeIds_.push_back(info->id);
+        }
+
+        // Type IDs are dense, so a direct table covers every ID up to the largest
+        if (!typeIds_.empty()) {
+            columns_.assign(static_cast<size_t>(typeIds_.back()) + 1, -1);
+            for (size_t i = 0; i < typeIds_.size(); ++i) {
+                columns_[typeIds_[i]] = static_cast<int>(i);
+            }
+        }
+
+        computeLayout();
+    }
+
+    Archetype::~Archetype() {
+        clear();
+    }
+
+    void Archetype::computeLayout() {
+        auto alignUp = [](size_t value, size_t align) {
+            return (value + align - 1) & ~(align - 1);
+        };
+
+        auto layoutBytes = [&](uint32_t rows) {
+            size_t bytes = sizeof(EntityID) * rows;
+            for (const auto* info : types_) {
+                bytes = alignUp(bytes, info->align) + info->size * rows;
+            }
+            return bytes;
+        };
+
+        size_t rowBytes = sizeof(EntityID);
+        for (const auto* info : types_) {
+            rowBytes += info->size;
+        }
+
+        // Largest row count that fits the chunk once column padding is added
+        uint32_t rows = static_cast<uint32_t>(CHUNK_SIZE / rowBytes);
+        while (rows > 1 && layoutBytes(rows) > CHUNK_SIZE) {
+            --rows;
+        }
+
+        // Oversized component sets still get one row per chunk
+        capacity_ = std::max<uint32_t>(rows, 1);
+        chunkBytes_ = std::max(CHUNK_SIZE, alignUp(layoutBytes(capacity_), CHUNK_ALIGN));
+
+        offsets_.clear();
+        size_t offset = sizeof(EntityID) * capacity_;
+        for (const auto* info : types_) {
+            offset = alignUp(offset, info->align);
+            offsets_.push_back(offset);
+            offset += info->size * capacity_;
+        }
+    }
+
+    std::pair<uint32_t, uint32_t> Archetype::allocateRow(EntityID entity) {
+        if (chunks_.empty() || chunks_.back().count == capacity_) {
+            Chunk chunk;
+            chunk.data = static_cast<std::byte*>(
+                ::operator new(chunkBytes_, std::align_val_t(CHUNK_ALIGN)));
+            chunks_.push_back(chunk);
+        }
+
+        uint32_t chunkIndex = static_cast<uint32_t>(chunks_.size() - 1);
+        Chunk& chunk = chunks_.back();
+        uint32_t row = chunk.count++;
+        entities(chunk)[row] = entity;
+        ++size_;
+
+        return { chunkIndex, row };
+    }
+
+    EntityID Archetype::removeRow(uint32_t chunkIndex, uint32_t row) {
+        assert(size_ > 0);
+
+        uint32_t lastChunk = static_cast<uint32_t>(chunks_.size() - 1);
+        uint32_t lastRow = chunks_[lastChunk].count - 1;
+        EntityID moved = INVALID_ENTITY;
+
+        if (chunkIndex != lastChunk || row != lastRow) {
+            // Fill the hole with the archetype's last row
+            for (size_t c = 0; c < types_.size(); ++c) {
+                void* src = element(lastChunk, lastRow, c);
+                types_[c]->moveConstruct(element(chunkIndex, row, c), src);
+                types_[c]->destroy(src);
+            }
+
+            moved = entities(chunks_[lastChunk])[lastRow];
+            entities(chunks_[chunkIndex])[row] = moved;
+        }
+
+        --size_;
+        if (--chunks_[lastChunk].count == 0) {
+            releaseChunk(chunks_[lastChunk]);
+            chunks_.pop_back();
+        }
+
+        return moved;
+    }
+
+    void Archetype::destroyRow(uint32_t chunkIndex, uint32_t row) {
+        for (size_t c = 0; c < types_.size(); ++c) {
+            types_[c]->destroy(element(chunkIndex, row, c));
+        }
+    }
+
+    void Archetype::clear() {
+        for (uint32_t c = 0; c < chunks_.size(); ++c) {
+            for (uint32_t row = 0; row < chunks_[c].count; ++row) {
+                destroyRow(c, row);
+            }
+            releaseChunk(chunks_[c]);
+        }
+        chunks_.clear();
+        size_ = 0;
+    }
+
+    MemoryUsage Archetype::getTableMemory() const {
+        MemoryUsage usage = vectorMemory(types_);
+        usage += vectorMemory(typeIds_);
+        usage += vectorMemory(columns_);
+        usage += vectorMemory(offsets_);
+        usage += vectorMemory(chunks_);
+        usage += hashMemory(addEdges);
+        usage += hashMemory(removeEdges);
+        return usage;
+    }
+
+    void Archetype::releaseChunk(Chunk& chunk) {
+        ::operator delete(chunk.data, std::align_val_t(CHUNK_ALIGN));
+        chunk.data = nullptr;
+        chunk.count = 0;
+    }
+
+    // ============================================================================
+    // ARCHETYPE STORAGE
+    // ============================================================================
+
+    const ArchetypeStorage::EntityLocation* ArchetypeStorage::find(EntityID entity) const {
+        uint32_t index = getEntityIndex(entity);
+        if (index >= locations_.size()) return nullptr;
+
+        const EntityLocation& loc = locations_[index];
+        if (!loc.archetype) return nullptr;
+
+        // Generation check: the row must still belong to this exact ID
+        const Archetype::Chunk& chunk = loc.archetype->getChunk(loc.chunk);
+        if (loc.archetype->entities(chunk)[loc.row] != entity) return nullptr;
+
+        return &loc;
+    }
+
+    ArchetypeStorage::EntityLocation& ArchetypeStorage::locate(EntityID entity) {
+        uint32_t index = getEntityIndex(entity);
+        if (index >= locations_.size()) {
+            locations_.resize(static_cast<size_t>(index) + 1);
+        }
+
+        // A stale generation still occupying the slot is dropped first
+        EntityLocation& loc = locations_[index];
+        if (loc.archetype && !find(entity)) {
+            destroySlot(index);
+        }
+        return loc;
+    }
+
+    Archetype* ArchetypeStorage::findOrCreateArchetype(std::vector<const ComponentTypeInfo*> types) {
+        std::sort(types.begin(), types.end(),
+            [](const ComponentTypeInfo* a, const ComponentTypeInfo* b) { return a->id < b->id; });
+
+        std::vector<ComponentTypeID> key;
+        key.reserve(types.size());
+        for (const auto* info : types) {
+            key.push_back(info->id);
+        }
+
+        auto it = archetypeIndex_.find(key);
+        if (it != archetypeIndex_.end()) return it->second;
+
+        archetypes_.push_back(std::make_unique<Archetype>(std::move(types)));
+        Archetype* archetype = archetypes_.back().get();
+        archetypeIndex_.emplace(std::move(key), archetype);
+        return archetype;
+    }
+
+    Archetype* ArchetypeStorage::getAddTarget(Archetype* source, const ComponentTypeInfo& info) {
+        auto it = source->addEdges.find(info.id);
+        if (it != source->addEdges.end()) return it->second;
+
+        std::vector<const ComponentTypeInfo*> types = source->getTypeInfos();
+        types.push_back(&info);
+
+        Archetype* target = findOrCreateArchetype(std::move(types));
+        source->addEdges[info.id] = target;
+        target->removeEdges[info.id] = source;
+        return target;
+    }
+
+    Archetype* ArchetypeStorage::getRemoveTarget(Archetype* source, ComponentTypeID type) {
+        auto it = source->removeEdges.find(type);
+        if (it != source->removeEdges.end()) return it->second;
+
+        std::vector<const ComponentTypeInfo*> types;
+        for (const auto* info : source->getTypeInfos()) {
+            if (info->id != type) types.push_back(info);
+        }
+
+        Archetype* target = findOrCreateArchetype(std::move(types));
+        source->removeEdges[type] = target;
+        target->addEdges[type] = source;
+        return target;
+    }
+
+    void ArchetypeStorage::moveEntity(EntityID entity, EntityLocation& loc, Archetype* target) {
+        auto [chunk, row] = target->allocateRow(entity);
+
+        if (Archetype* source = loc.archetype) {
+            const auto& types = source->getTypeInfos();
+            for (size_t c = 0; c < types.size(); ++c) {
+                void* src = source->element(loc.chunk, loc.row, c);
+                int dstColumn = target->columnOf(types[c]->id);
+                if (dstColumn >= 0) {
+                    types[c]->moveConstruct(target->element(chunk, row, dstColumn), src);
+                }
+                types[c]->destroy(src);
+            }
+
+            EntityID moved = source->removeRow(loc.chunk, loc.row);
+            if (moved != INVALID_ENTITY) {
+                locations_[getEntityIndex(moved)] = { source, loc.chunk, loc.row };
+            }
+        }
+
+        loc = { target, chunk, row };
+    }
+
+    void ArchetypeStorage::removeType(EntityID entity, ComponentTypeID type) {
+        if (!find(entity)) return;
+
+        EntityLocation& loc = locations_[getEntityIndex(entity)];
+        if (loc.archetype->columnOf(type) < 0) return;
+
+        moveEntity(entity, loc, getRemoveTarget(loc.archetype, type));
+    }
+
+    void ArchetypeStorage::spawn(const EntityID* entities, size_t count,
+        const std::vector<const ComponentTypeInfo*>& types, const std::vector<const void*>& values) {
+        if (count == 0 || types.empty()) return;
+
+        Archetype* target = findOrCreateArchetype(types);
+
+        std::vector<int> columns(types.size());
+        for (size_t i = 0; i < types.size(); ++i) {
+            columns[i] = target->columnOf(types[i]->id);
+        }
+
+        for (size_t e = 0; e < count; ++e) {
+            EntityLocation& loc = locate(entities[e]);
+            assert(!loc.archetype && "spawn expects entities without components");
+
+            auto [chunk, row] = target->allocateRow(entities[e]);
+            for (size_t i = 0; i < types.size(); ++i) {
+                types[i]->copyConstruct(target->element(chunk, row, columns[i]), values[i]);
+            }
+            loc = { target, chunk, row };
+        }
+    }
+
+    void ArchetypeStorage::destroy(EntityID entity) {
+        if (!find(entity)) return;
+        destroySlot(getEntityIndex(entity));
+    }
+
+    void ArchetypeStorage::destroySlot(uint32_t index) {
+        EntityLocation loc = locations_[index];
+
+        loc.archetype->destroyRow(loc.chunk, loc.row);
+        EntityID moved = loc.archetype->removeRow(loc.chunk, loc.row);
+        if (moved != INVALID_ENTITY) {
+            locations_[getEntityIndex(moved)] = loc;
+        }
+
+        locations_[index] = EntityLocation{};
+    }
+
+    void ArchetypeStorage::collectMemory(std::vector<ComponentMemory>& perType, MemoryUsage& overhead) const {
+        for (const auto& archetype : archetypes_) {
+            const auto& types = archetype->getTypeInfos();
+            size_t rows = archetype->size();
+            size_t slots = archetype->getChunkCount() * archetype->getChunkCapacity();
+
+            // Chunk bytes not claimed by a component column
+            MemoryUsage rest = { rows * sizeof(EntityID), archetype->getChunkCount() * archetype->getChunkBytes() };
+
+            for (size_t c = 0; c < types.size(); ++c) {
+                const ComponentTypeInfo& info = *types[c];
+                if (info.id >= perType.size()) perType.resize(static_cast<size_t>(info.id) + 1);
+
+                ComponentMemory& memory = perType[info.id];
+                memory.components += MemoryUsage{ rows * info.size, slots * info.size };
+                rest.reserved -= slots * info.size;
+
+                if (!info.ownsHeap) continue;
+                for (uint32_t chunk = 0; chunk < archetype->getChunkCount(); ++chunk) {
+                    for (uint32_t row = 0; row < archetype->getChunk(chunk).count; ++row) {
+                        memory.owned += info.heapMemory(archetype->element(chunk, row, c));
+                    }
+                }
+            }
+
+            overhead += rest;
+            overhead += archetype->getTableMemory();
+            overhead.used += sizeof(Archetype);
+            overhead.reserved += sizeof(Archetype);
+        }
+
+        overhead += vectorMemory(archetypes_);
+        overhead += vectorMemory(locations_);
+        for (const auto& [key, archetype] : archetypeIndex_) {
+            // Tree node (three links + color) plus the key's buffer
+            size_t node = 4 * sizeof(void*) + sizeof(key) + sizeof(archetype);
+            overhead += MemoryUsage{ node, node };
+            overhead += vectorMemory(key);
+        }
+    }
+
+    void ArchetypeStorage::shrinkToFit() {
+        while (!locations_.empty() && !locations_.back().archetype) {
+            locations_.pop_back();
+        }
+        locations_.shrink_to_fit();
+
+        for (auto& archetype : archetypes_) {
+            archetype->shrinkToFit();
+        }
+    }
+
+    void ArchetypeStorage::clear() {
+        for (auto& archetype : archetypes_) {
+            archetype->clear();
+        }
+        locations_.clear();
+    }
+
+} // namespace libre
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <array>
+#include <tuple>
+#include <typeinfo>
+
+namespace libre {
+
+    // ============================================================================
+    // COMPONENT TYPE INFO - Type-erased lifetime operations for archetype columns
+    // ============================================================================
+
+    struct ComponentTypeInfo {
+        ComponentTypeID id = 0;
+        size_t size = 0;
+        size_t align = 0;
+        void (*moveConstruct)(void* dst, void* src) = nullptr;
+        void (*copyConstruct)(void* dst, const void* src) = nullptr;
+        void (*destroy)(void* ptr) = nullptr;
+        MemoryUsage (*heapMemory)(const void* ptr) = nullptr;
+        bool ownsHeap = false;              // heapMemory() can be non-zero
+        const char* name = nullptr;         // typeid name, for reports
+
+        template<typename T>
+        static const ComponentTypeInfo& of() {
+            static const ComponentTypeInfo info = {
+                getComponentTypeID<T>(),
+                sizeof(T),
+                alignof(T),
+                [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); },
+                [](void* dst, const void* src) { new (dst) T(*static_cast<const T*>(src)); },
+                [](void* ptr) { static_cast<T*>(ptr)->~T(); },
+                [](const void* ptr) { return componentHeapMemory(*static_cast<const T*>(ptr)); },
+                detail::HasHeapMemory<T>::value,
+                typeid(T).name()
+            };
+            return info;
+        }
+    };
+
+    // ============================================================================
+    // ARCHETYPE - All entities that share one exact component set
+    // ============================================================================
+    // Entities are packed into fixed-size chunks. Each chunk holds an entity ID
+    // column followed by one column per component type (SoA), so a loop over
+    // an archetype is a linear stream through every column it touches.
+
+    class Archetype {
+    public:
+        static constexpr size_t CHUNK_SIZE = 16 * 1024;
+        static constexpr size_t CHUNK_ALIGN = 64;
+
+        struct Chunk {
+            std::byte* data = nullptr;
+            uint32_t count = 0;
+        };
+
+        explicit Archetype(std::vector<const ComponentTypeInfo*> types);
+        ~Archetype();
+
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        // Component set (sorted by type ID)
+        const std::vector<ComponentTypeID>& getTypes() const { return typeIds_; }
+        const std::vector<const ComponentTypeInfo*>& getTypeInfos() const { return types_; }
+
+        // Column index of a type, or -1 if the archetype doesn't contain it
+        int columnOf(ComponentTypeID type) const {
+            return type < columns_.size() ? columns_[type] : -1;
+        }
+
+        uint32_t getChunkCapacity() const { return capacity_; }
+        size_t getChunkBytes() const { return chunkBytes_; }
+        size_t getChunkCount() const { return chunks_.size(); }
+        size_t size() const { return size_; }
+
+        Chunk& getChunk(size_t index) { return chunks_[index]; }
+        const Chunk& getChunk(size_t index) const { return chunks_[index]; }
+
+        EntityID* entities(const Chunk& chunk) const {
+            return reinterpret_cast<EntityID*>(chunk.data);
+        }
+
+        void* column(const Chunk& chunk, size_t column) const {
+            return chunk.data + offsets_[column];
+        }
+
+        void* element(uint32_t chunk, uint32_t row, size_t column) const {
+            return chunks_[chunk].data + offsets_[column] + row * types_[column]->size;
+        }
+
+        // Reserve a row for entity. Component slots are left unconstructed.
+        std::pair<uint32_t, uint32_t> allocateRow(EntityID entity);
+
+        // Remove a row whose components were already moved out or destroyed.
+        // The archetype's last row is moved into the hole; its entity is
+        // returned so the caller can fix up its location (INVALID_ENTITY if
+        // no row moved).
+        EntityID removeRow(uint32_t chunk, uint32_t row);
+
+        // Destroy every component in a row (leaves the row allocated)
+        void destroyRow(uint32_t chunk, uint32_t row);
+
+        void clear();
+
+        // Bytes of this archetype's bookkeeping (columns, offsets, chunk
+        // list, transition edges), not the chunks themselves
+        MemoryUsage getTableMemory() const;
+        void shrinkToFit() { chunks_.shrink_to_fit(); }
+
+        // Cached structural transitions
+        std::unordered_map<ComponentTypeID, Archetype*> addEdges;
+        std::unordered_map<ComponentTypeID, Archetype*> removeEdges;
+
+    private:
+        void computeLayout();
+        void releaseChunk(Chunk& chunk);
+
+        std::vector<const ComponentTypeInfo*> types_;
+        std::vector<ComponentTypeID> typeIds_;
+        std::vector<int> columns_;        // Column per type ID, -1 if absent
+        std::vector<size_t> offsets_;     // Byte offset of each column in a chunk
+        std::vector<Chunk> chunks_;
+        uint32_t capacity_ = 0;           // Rows per chunk
+        size_t chunkBytes_ = CHUNK_SIZE;
+        size_t size_ = 0;
+    };
+
+    // ============================================================================
+    // ARCHETYPE STORAGE - Optional World backend
+    // ============================================================================
+    // Structural changes (add/remove component) move the entity's row into the
+    // archetype for its new component set. Component pointers are only stable
+    // until the next structural change of any entity in the same archetype.
+
+    class ArchetypeStorage {
+    public:
+        ArchetypeStorage() = default;
+        ~ArchetypeStorage() = default;
+
+        ArchetypeStorage(const ArchetypeStorage&) = delete;
+        ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+        // Add or replace component
+        template<typename T>
+        T& add(EntityID entity, const T& component = T{}) {
+            return emplace<T>(entity, component);
+        }
+
+        template<typename T, typename = std::enable_if_t<!std::is_lvalue_reference_v<T>>>
+        T& add(EntityID entity, T&& component) {
+            return emplace<T>(entity, std::move(component));
+        }
+
+        // Construct (or replace) the component from constructor args
+        template<typename T, typename... Args>
+        T& emplace(EntityID entity, Args&&... args) {
+            const ComponentTypeInfo& info = ComponentTypeInfo::of<T>();
+
+            if (T* existing = get<T>(entity)) {
+                detail::assignComponent(*existing, std::forward<Args>(args)...);
+                return *existing;
+            }
+
+            // Built before the row moves, in case args refer into it
+            T value(std::forward<Args>(args)...);
+
+            EntityLocation& loc = locate(entity);
+            Archetype* target = loc.archetype
+                ? getAddTarget(loc.archetype, info)
+                : findOrCreateArchetype({ &info });
+
+            moveEntity(entity, loc, target);
+
+            T* slot = static_cast<T*>(target->element(loc.chunk, loc.row, target->columnOf(info.id)));
+            new (slot) T(std::move(value));
+            return *slot;
+        }
+
+        template<typename T>
+        T* get(EntityID entity) {
+            const EntityLocation* loc = find(entity);
+            if (!loc) return nullptr;
+
+            int column = loc->archetype->columnOf(getComponentTypeID<T>());
+            if (column < 0) return nullptr;
+            return static_cast<T*>(loc->archetype->element(loc->chunk, loc->row, column));
+        }
+
+        template<typename T>
+        const T* get(EntityID entity) const {
+            return const_cast<ArchetypeStorage*>(this)->get<T>(entity);
+        }
+
+        template<typename T>
+        bool has(EntityID entity) const {
+            return hasType(entity, getComponentTypeID<T>());
+        }
+
+        bool hasType(EntityID entity, ComponentTypeID type) const {
+            const EntityLocation* loc = find(entity);
+            return loc && loc->archetype->columnOf(type) >= 0;
+        }
+
+        template<typename T>
+        void remove(EntityID entity) {
+            removeType(entity, getComponentTypeID<T>());
+        }
+
+        // Place entities that have no components yet straight into the
+        // archetype for 'types', copy-constructing column c from values[c].
+        // values is parallel to types.
+        void spawn(const EntityID* entities, size_t count,
+            const std::vector<const ComponentTypeInfo*>& types, const std::vector<const void*>& values);
+
+        // Remove the entity and all of its components
+        void destroy(EntityID entity);
+
+        bool contains(EntityID entity) const { return find(entity) != nullptr; }
+
+        // Iterate every entity that has all of Ts: func(EntityID, Ts&...)
+        template<typename... Ts, typename Func>
+        void each(Func&& func) {
+            static_assert(sizeof...(Ts) > 0, "each needs at least one component");
+            const std::array<ComponentTypeID, sizeof...(Ts)> ids = { getComponentTypeID<Ts>()... };
+
+            for (auto& archetype : archetypes_) {
+                std::array<int, sizeof...(Ts)> columns;
+                bool match = true;
+                for (size_t i = 0; i < ids.size(); ++i) {
+                    columns[i] = archetype->columnOf(ids[i]);
+                    match = match && columns[i] >= 0;
+                }
+                if (!match || archetype->size() == 0) continue;
+
+                eachInArchetype<Ts...>(*archetype, columns, func, std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        // A chunk that holds all of some component set, for splitting work
+        struct ChunkRef {
+            Archetype* archetype = nullptr;
+            uint32_t chunk = 0;
+        };
+
+        template<typename... Ts>
+        std::vector<ChunkRef> matchingChunks() const {
+            const std::array<ComponentTypeID, sizeof...(Ts)> ids = { getComponentTypeID<Ts>()... };
+
+            std::vector<ChunkRef> result;
+            for (auto& archetype : archetypes_) {
+                bool match = true;
+                for (ComponentTypeID id : ids) {
+                    match = match && archetype->columnOf(id) >= 0;
+                }
+                if (!match) continue;
+
+                for (size_t c = 0; c < archetype->getChunkCount(); ++c) {
+                    result.push_back({ archetype.get(), static_cast<uint32_t>(c) });
+                }
+            }
+            return result;
+        }
+
+        // Iterate one chunk returned by matchingChunks<Ts...>()
+        template<typename... Ts, typename Func>
+        void eachInChunk(const ChunkRef& ref, Func&& func) {
+            const std::array<int, sizeof...(Ts)> columns = { ref.archetype->columnOf(getComponentTypeID<Ts>())... };
+            eachInChunkImpl<Ts...>(*ref.archetype, ref.archetype->getChunk(ref.chunk), columns, func,
+                std::index_sequence_for<Ts...>{});
+        }
+
+        void clear();
+
+        // Bytes per component type, indexed by type ID (perType is grown as
+        // needed). Entity ID columns, chunk padding and lookup tables go to
+        // 'overhead'.
+        void collectMemory(std::vector<ComponentMemory>& perType, MemoryUsage& overhead) const;
+
+        // Trim the location table and chunk lists after large removals
+        void shrinkToFit();
+
+        size_t getArchetypeCount() const { return archetypes_.size(); }
+        const std::vector<std::unique_ptr<Archetype>>& getArchetypes() const { return archetypes_; }
+
+    private:
+        struct EntityLocation {
+            Archetype* archetype = nullptr;
+            uint32_t chunk = 0;
+            uint32_t row = 0;
+        };
+
+        template<typename... Ts, typename Func, size_t... I>
+        void eachInArchetype(Archetype& archetype, const std::array<int, sizeof...(Ts)>& columns,
+            Func& func, std::index_sequence<I...> seq) {
+            for (size_t c = 0; c < archetype.getChunkCount(); ++c) {
+                eachInChunkImpl<Ts...>(archetype, archetype.getChunk(c), columns, func, seq);
+            }
+        }
+
+        template<typename... Ts, typename Func, size_t... I>
+        void eachInChunkImpl(Archetype& archetype, const Archetype::Chunk& chunk,
+            const std::array<int, sizeof...(Ts)>& columns, Func& func, std::index_sequence<I...>) {
+            const EntityID* entities = archetype.entities(chunk);
+            std::tuple<Ts*...> cols(static_cast<Ts*>(archetype.column(chunk, columns[I]))...);
+
+            for (uint32_t row = 0; row < chunk.count; ++row) {
+                func(entities[row], std::get<I>(cols)[row]...);
+            }
+        }
+
+        const EntityLocation* find(EntityID entity) const;
+        EntityLocation& locate(EntityID entity);
+
+        Archetype* findOrCreateArchetype(std::vector<const ComponentTypeInfo*> types);
+        Archetype* getAddTarget(Archetype* source, const ComponentTypeInfo& info);
+        Archetype* getRemoveTarget(Archetype* source, ComponentTypeID type);
+
+        // Move entity's row into 'target'. Components shared by both archetypes
+        // are moved, components missing from 'target' are destroyed, and new
+        // columns are left unconstructed for the caller.
+        void moveEntity(EntityID entity, EntityLocation& loc, Archetype* target);
+        void removeType(EntityID entity, ComponentTypeID type);
+        void destroySlot(uint32_t index);
+
+        std::vector<std::unique_ptr<Archetype>> archetypes_;
+        std::map<std::vector<ComponentTypeID>, Archetype*> archetypeIndex_;
+        std::vector<EntityLocation> locations_;     // Indexed by entity index
+    };
+
+} // namespace libre
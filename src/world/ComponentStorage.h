@@ -2,13 +2,227 @@
 
 #include "Types.h"
 #include <vector>
-#include <unordered_map>
+#include <memory>
 #include <optional>
 #include <cassert>
 #include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <atomic>
+#include <typeinfo>
 
 namespace libre {
 
+    // ============================================================================
+    // ENTITY SPARSE SET - Paged entity index -> dense index map
+    // ============================================================================
+    // The sparse side is split into fixed-size pages that are allocated on first
+    // use, so a few high entity indices don't force a huge flat array. Lookup is
+    // two array reads: the page slot, then the dense entity ID, which also acts
+    // as the generation check for stale handles.
+
+    class EntitySparseSet {
+    public:
+        static constexpr size_t PAGE_SIZE = 4096;
+        static constexpr uint32_t NPOS = 0xFFFFFFFF;
+
+        // Dense index of entity, or NPOS if not present
+        uint32_t find(EntityID entity) const {
+            uint32_t index = getEntityIndex(entity);
+            size_t page = index / PAGE_SIZE;
+            if (page >= pages_.size() || !pages_[page]) return NPOS;
+
+            uint32_t dense = pages_[page][index % PAGE_SIZE];
+            if (dense == NPOS || dense_[dense] != entity) return NPOS;
+            return dense;
+        }
+
+        bool contains(EntityID entity) const {
+            return find(entity) != NPOS;
+        }
+
+        // Dense slot currently owned by this entity index (any generation)
+        uint32_t findSlot(EntityID entity) const {
+            uint32_t index = getEntityIndex(entity);
+            size_t page = index / PAGE_SIZE;
+            if (page >= pages_.size() || !pages_[page]) return NPOS;
+            return pages_[page][index % PAGE_SIZE];
+        }
+
+        // Append entity to the dense array, returns its dense index
+        uint32_t insert(EntityID entity) {
+            uint32_t dense = static_cast<uint32_t>(dense_.size());
+            dense_.push_back(entity);
+            slot(entity) = dense;
+            return dense;
+        }
+
+        // Put entity into a free dense slot (one left by tombstone())
+        void insertAt(uint32_t dense, EntityID entity) {
+            dense_[dense] = entity;
+            slot(entity) = dense;
+        }
+
+        // Leave a hole at 'dense' instead of moving the last entity into it.
+        // The hole holds INVALID_ENTITY until insertAt() reuses it.
+        void tombstone(uint32_t dense) {
+            slot(dense_[dense]) = NPOS;
+            dense_[dense] = INVALID_ENTITY;
+        }
+
+        // Re-target an existing slot (stale generation replaced by a new one)
+        void rebind(uint32_t dense, EntityID entity) {
+            dense_[dense] = entity;
+        }
+
+        // Drop a trailing hole left by tombstone()
+        void popHole() {
+            assert(!dense_.empty() && dense_.back() == INVALID_ENTITY);
+            dense_.pop_back();
+        }
+
+        // Swap-remove the entity at 'dense'. The last entity is moved into the
+        // hole; callers mirror the same move in their component arrays.
+        void swapRemove(uint32_t dense) {
+            uint32_t last = static_cast<uint32_t>(dense_.size() - 1);
+            EntityID removed = dense_[dense];
+
+            if (dense != last) {
+                dense_[dense] = dense_[last];
+                slot(dense_[dense]) = dense;
+            }
+
+            slot(removed) = NPOS;
+            dense_.pop_back();
+        }
+
+        void clear() {
+            dense_.clear();
+            pages_.clear();
+        }
+
+        void reserve(size_t count) { dense_.reserve(count); }
+        void reserveMore(size_t extra) { libre::reserveMore(dense_, extra); }
+        size_t size() const { return dense_.size(); }
+
+        // Sparse pages count as used only for the live entries they map
+        MemoryUsage getMemoryUsage(size_t liveCount) const {
+            MemoryUsage usage = vectorMemory(dense_);
+            usage += vectorMemory(pages_);
+            for (const auto& page : pages_) {
+                if (page) usage.reserved += PAGE_SIZE * sizeof(uint32_t);
+            }
+            usage.used += liveCount * sizeof(uint32_t);
+            return usage;
+        }
+
+        // Free sparse pages that map nothing and surplus dense capacity
+        void shrinkToFit() {
+            for (auto& page : pages_) {
+                if (page && std::all_of(page.get(), page.get() + PAGE_SIZE,
+                    [](uint32_t dense) { return dense == NPOS; })) {
+                    page.reset();
+                }
+            }
+            while (!pages_.empty() && !pages_.back()) {
+                pages_.pop_back();
+            }
+            pages_.shrink_to_fit();
+            dense_.shrink_to_fit();
+        }
+
+        EntityID* data() { return dense_.data(); }
+        const EntityID* data() const { return dense_.data(); }
+        const std::vector<EntityID>& dense() const { return dense_; }
+
+    private:
+        uint32_t& slot(EntityID entity) {
+            uint32_t index = getEntityIndex(entity);
+            size_t page = index / PAGE_SIZE;
+
+            if (page >= pages_.size()) {
+                pages_.resize(page + 1);
+            }
+            if (!pages_[page]) {
+                pages_[page] = std::make_unique<uint32_t[]>(PAGE_SIZE);
+                std::fill_n(pages_[page].get(), PAGE_SIZE, NPOS);
+            }
+            return pages_[page][index % PAGE_SIZE];
+        }
+
+        std::vector<EntityID> dense_;                        // Dense entity IDs
+        std::vector<std::unique_ptr<uint32_t[]>> pages_;     // Sparse pages
+    };
+
+    // ============================================================================
+    // PAGED ARRAY - Growable array whose elements never move
+    // ============================================================================
+    // Growing appends a page instead of reallocating, so existing elements are
+    // neither copied nor moved. Pages are value-initialized when allocated and
+    // pop_back() resets the slot to T{}, which releases what the element owned.
+
+    template<typename T, size_t PageSize>
+    class PagedArray {
+    public:
+        T& operator[](size_t index) { return pages_[index / PageSize][index % PageSize]; }
+        const T& operator[](size_t index) const { return pages_[index / PageSize][index % PageSize]; }
+
+        T& back() { return (*this)[size_ - 1]; }
+        const T& back() const { return (*this)[size_ - 1]; }
+
+        template<typename... Args>
+        T& emplace_back(Args&&... args) {
+            reserve(size_ + 1);
+            T& slot = (*this)[size_];
+            detail::assignComponent(slot, std::forward<Args>(args)...);
+            ++size_;
+            return slot;
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        void pop_back() {
+            back() = T{};
+            --size_;
+        }
+
+        void reserve(size_t count) {
+            while (capacity() < count) {
+                pages_.push_back(std::make_unique<T[]>(PageSize));
+            }
+        }
+
+        void clear() {
+            pages_.clear();
+            size_ = 0;
+        }
+
+        // Release pages past the last element
+        void shrink_to_fit() {
+            pages_.resize((size_ + PageSize - 1) / PageSize);
+            pages_.shrink_to_fit();
+        }
+
+        size_t size() const { return size_; }
+        size_t capacity() const { return pages_.size() * PageSize; }
+
+        MemoryUsage getMemoryUsage() const {
+            MemoryUsage usage = vectorMemory(pages_);
+            usage.used += size_ * sizeof(T);
+            usage.reserved += capacity() * sizeof(T);
+            return usage;
+        }
+
+        // Contiguous block holding elements [page * PageSize, (page + 1) * PageSize)
+        T* page(size_t page) { return pages_[page].get(); }
+        const T* page(size_t page) const { return pages_[page].get(); }
+
+    private:
+        std::vector<std::unique_ptr<T[]>> pages_;
+        size_t size_ = 0;
+    };
+
     // ============================================================================
     // COMPONENT STORAGE BASE
     // ============================================================================
@@ -18,87 +232,329 @@ namespace libre {
         virtual ~IComponentStorage() = default;
         virtual void remove(EntityID entity) = 0;
         virtual bool has(EntityID entity) const = 0;
+
+        // Remove many entities' components (absent ones are skipped)
+        virtual void removeBulk(const EntityID* entities, size_t count) {
+            for (size_t i = 0; i < count; ++i) remove(entities[i]);
+        }
+
         virtual void clear() = 0;
         virtual size_t size() const = 0;
+
+        // Bytes held for this component type
+        virtual ComponentMemory getMemoryUsage() const = 0;
+
+        // Give back capacity left over after large removals. Doesn't move
+        // components of pointer-stable types.
+        virtual void shrinkToFit() = 0;
+
+        // Compiler-specific type name (typeid), for reports
+        virtual const char* getTypeName() const = 0;
+
+        // Change tick stamped on writes. World binds every storage to its
+        // atomic clock so advancing it is safe while systems write; a
+        // standalone storage keeps its own and uses setChangeTick().
+        void bindChangeClock(const std::atomic<uint32_t>* clock) { clock_ = clock ? clock : &ownClock_; }
+        void setChangeTick(uint32_t tick) { ownClock_.store(tick, std::memory_order_relaxed); }
+        uint32_t getChangeTick() const { return clock_->load(std::memory_order_relaxed); }
+
+        // Forget change/removal records with tick <= upTo. Not safe while
+        // the storage is being written or queried.
+        virtual void trimChangeLog(uint32_t upTo) { (void)upTo; }
+
+    private:
+        std::atomic<uint32_t> ownClock_{ 1 };
+        const std::atomic<uint32_t>* clock_ = &ownClock_;
+    };
+
+    // ============================================================================
+    // COMPONENT TICKS - Per-slot change tracking
+    // ============================================================================
+
+    struct ComponentTicks {
+        uint32_t added = 0;       // Tick the component was added
+        uint32_t changed = 0;     // Tick of the last tracked write (add/getMut)
+        uint32_t logIndex = 0;    // Absolute position of the latest change log entry
     };
 
     // ============================================================================
     // COMPONENT STORAGE - Dense array with entity mapping
     // ============================================================================
-    // Optimized for iteration (cache-friendly) while maintaining O(1) lookup
+    // Optimized for iteration (cache-friendly) while maintaining O(1) lookup.
+    // Layout follows ComponentStorageTraits<T>: a std::vector with swap-remove
+    // by default, or a PagedArray with holes for pointer-stable types. Holes
+    // show up as INVALID_ENTITY in entityData(); denseSize() counts them,
+    // size() doesn't.
+    //
+    // Writes through add() and getMut()/markChanged() stamp the slot with the
+    // current change tick and append it to a change log ordered by tick (at
+    // most once per slot per tick). forEachChanged/forEachAdded binary-search
+    // the log, so a query costs O(changed), not O(size). Plain get(), forEach()
+    // and data() are untracked. Superseded entries are compacted away by
+    // trimChangeLog(), so owners should trim regularly.
 
     template<typename T>
     class ComponentStorage : public IComponentStorage {
     public:
+        static constexpr bool POINTER_STABLE = ComponentStorageTraits<T>::pointerStable;
+
+        using Container = std::conditional_t<POINTER_STABLE,
+            PagedArray<T, ComponentStorageTraits<T>::pageSize>, std::vector<T>>;
+
         // Add or replace component
         T& add(EntityID entity, const T& component = T{}) {
-            auto it = entityToIndex_.find(entity);
+            return emplace(entity, component);
+        }
+
+        // Add or replace by moving (mesh buffers are taken, not copied)
+        T& add(EntityID entity, T&& component) {
+            return emplace(entity, std::move(component));
+        }
 
-            if (it != entityToIndex_.end()) {
-                // Replace existing
-                components_[it->second] = component;
-                return components_[it->second];
+        // Construct (or replace) the component in place from constructor args
+        template<typename... Args>
+        T& emplace(EntityID entity, Args&&... args) {
+            uint32_t index = index_.findSlot(entity);
+
+            if (index != EntitySparseSet::NPOS) {
+                // Replace existing (or a stale generation of the same index)
+                if (index_.dense()[index] != entity) {
+                    ticks_[index].added = getChangeTick();
+                    ticks_[index].changed = 0;
+                }
+                index_.rebind(index, entity);
+                detail::assignComponent(components_[index], std::forward<Args>(args)...);
+                touch(index);
+                return components_[index];
             }
 
             // Add new
-            size_t index = components_.size();
-            components_.push_back(component);
-            entities_.push_back(entity);
-            entityToIndex_[entity] = index;
+            ComponentTicks ticks;
+            ticks.added = getChangeTick();
+            index = insertNew(entity, ticks, std::forward<Args>(args)...);
+            touch(index);
 
-            return components_.back();
+            return components_[index];
+        }
+
+        // Add the same component to many entities (one reserve, one tick)
+        void addBulk(const EntityID* entities, size_t count, const T& component) {
+            if constexpr (POINTER_STABLE) {
+                components_.reserve(components_.size() + count);   // Adds pages, moves nothing
+            }
+            else {
+                reserveMore(components_, count);
+            }
+            reserveMore(ticks_, count);
+            index_.reserveMore(count);
+            reserveMore(changeLog_, count);
+
+            ComponentTicks ticks;
+            ticks.added = getChangeTick();
+
+            for (size_t i = 0; i < count; ++i) {
+                if (index_.findSlot(entities[i]) != EntitySparseSet::NPOS) {
+                    add(entities[i], component);
+                    continue;
+                }
+
+                touch(insertNew(entities[i], ticks, component));
+            }
         }
 
         // Get component (returns nullptr if not found)
         T* get(EntityID entity) {
-            auto it = entityToIndex_.find(entity);
-            if (it == entityToIndex_.end()) return nullptr;
-            return &components_[it->second];
+            uint32_t index = index_.find(entity);
+            return index != EntitySparseSet::NPOS ? &components_[index] : nullptr;
         }
 
         const T* get(EntityID entity) const {
-            auto it = entityToIndex_.find(entity);
-            if (it == entityToIndex_.end()) return nullptr;
-            return &components_[it->second];
+            uint32_t index = index_.find(entity);
+            return index != EntitySparseSet::NPOS ? &components_[index] : nullptr;
+        }
+
+        // Get component for writing (marks it changed)
+        T* getMut(EntityID entity) {
+            uint32_t index = index_.find(entity);
+            if (index == EntitySparseSet::NPOS) return nullptr;
+            touch(index);
+            return &components_[index];
+        }
+
+        void markChanged(EntityID entity) {
+            uint32_t index = index_.find(entity);
+            if (index != EntitySparseSet::NPOS) touch(index);
         }
 
         // Check if entity has component
         bool has(EntityID entity) const override {
-            return entityToIndex_.find(entity) != entityToIndex_.end();
+            return index_.contains(entity);
         }
 
         // Remove component
         void remove(EntityID entity) override {
-            auto it = entityToIndex_.find(entity);
-            if (it == entityToIndex_.end()) return;
+            uint32_t index = index_.find(entity);
+            if (index == EntitySparseSet::NPOS) return;
+            removeAt(index, getChangeTick());
+        }
 
-            size_t index = it->second;
-            size_t lastIndex = components_.size() - 1;
+        // Swap-removes in descending dense order, so the element moved into
+        // each hole is never one that still has to be removed
+        void removeBulk(const EntityID* entities, size_t count) override {
+            if (count == 1) {
+                remove(entities[0]);
+                return;
+            }
 
-            if (index != lastIndex) {
-                // Swap with last element
-                components_[index] = std::move(components_[lastIndex]);
-                entities_[index] = entities_[lastIndex];
-                entityToIndex_[entities_[index]] = index;
+            std::vector<uint32_t> indices;
+            indices.reserve(std::min(count, components_.size()));
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t index = index_.find(entities[i]);
+                if (index != EntitySparseSet::NPOS) indices.push_back(index);
             }
+            if (indices.empty()) return;
 
-            components_.pop_back();
-            entities_.pop_back();
-            entityToIndex_.erase(entity);
+            std::sort(indices.begin(), indices.end(), std::greater<uint32_t>());
+            indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+            uint32_t tick = getChangeTick();
+            reserveMore(removedLog_, indices.size());
+            for (uint32_t index : indices) {
+                removeAt(index, tick);
+            }
         }
 
-        // Clear all components
+        // Clear all components (recorded as removals)
         void clear() override {
+            uint32_t tick = getChangeTick();
+            for (EntityID entity : index_.dense()) {
+                if (entity != INVALID_ENTITY) removedLog_.push_back({ entity, tick });
+            }
+
             components_.clear();
-            entities_.clear();
-            entityToIndex_.clear();
+            ticks_.clear();
+            index_.clear();
+            holes_.clear();
+
+            changeLogBase_ += static_cast<uint32_t>(changeLog_.size());
+            changeLog_.clear();
         }
 
-        // Get count
+        // Number of components
         size_t size() const override {
+            return components_.size() - holes_.size();
+        }
+
+        // Number of dense slots, holes included (bound for index loops)
+        size_t denseSize() const {
             return components_.size();
         }
 
+        ComponentMemory getMemoryUsage() const override {
+            ComponentMemory memory;
+            if constexpr (POINTER_STABLE) {
+                memory.components = components_.getMemoryUsage();
+                memory.components.used -= holes_.size() * sizeof(T);
+            }
+            else {
+                memory.components = vectorMemory(components_);
+            }
+
+            if constexpr (detail::HasHeapMemory<T>::value) {
+                forEach([&](EntityID, const T& component) {
+                    memory.owned += component.getHeapMemory();
+                    });
+            }
+
+            memory.index = index_.getMemoryUsage(size());
+            memory.index += vectorMemory(ticks_);
+            memory.index += vectorMemory(holes_);
+            memory.index += vectorMemory(changeLog_);
+            memory.index += vectorMemory(removedLog_);
+            return memory;
+        }
+
+        void shrinkToFit() override {
+            if constexpr (POINTER_STABLE) {
+                // Trailing holes can go; interior ones stay so nothing moves
+                while (components_.size() > 0 && index_.dense().back() == INVALID_ENTITY) {
+                    components_.pop_back();
+                    ticks_.pop_back();
+                    index_.popHole();
+                }
+                uint32_t end = static_cast<uint32_t>(components_.size());
+                holes_.erase(std::remove_if(holes_.begin(), holes_.end(),
+                    [end](uint32_t hole) { return hole >= end; }), holes_.end());
+            }
+
+            components_.shrink_to_fit();
+            ticks_.shrink_to_fit();
+            holes_.shrink_to_fit();
+            index_.shrinkToFit();
+            changeLog_.shrink_to_fit();
+            removedLog_.shrink_to_fit();
+        }
+
+        const char* getTypeName() const override { return typeid(T).name(); }
+
+        // Dense index of entity (EntitySparseSet::NPOS if absent)
+        uint32_t indexOf(EntityID entity) const {
+            return index_.find(entity);
+        }
+
+        // ========================================================================
+        // CHANGE TRACKING
+        // ========================================================================
+
+        const ComponentTicks* getTicks(EntityID entity) const {
+            uint32_t index = index_.find(entity);
+            return index != EntitySparseSet::NPOS ? &ticks_[index] : nullptr;
+        }
+
+        // Components added or written after 'since': func(EntityID, T&)
+        template<typename Func>
+        void forEachChanged(uint32_t since, Func&& func) {
+            visitChangeLog(since, [&](uint32_t index) {
+                func(index_.data()[index], components_[index]);
+                });
+        }
+
+        // Components added after 'since': func(EntityID, T&)
+        template<typename Func>
+        void forEachAdded(uint32_t since, Func&& func) {
+            visitChangeLog(since, [&](uint32_t index) {
+                if (ticks_[index].added > since) {
+                    func(index_.data()[index], components_[index]);
+                }
+                });
+        }
+
+        // Entities that lost this component after 'since': func(EntityID).
+        // An entity removed and re-added is reported here and by forEachAdded.
+        template<typename Func>
+        void forEachRemoved(uint32_t since, Func&& func) const {
+            auto it = std::upper_bound(removedLog_.begin(), removedLog_.end(), since,
+                [](uint32_t tick, const ChangeRecord& record) { return tick < record.tick; });
+            for (; it != removedLog_.end(); ++it) {
+                func(it->entity);
+            }
+        }
+
+        void trimChangeLog(uint32_t upTo) override {
+            auto byTick = [](const ChangeRecord& record, uint32_t tick) { return record.tick <= tick; };
+
+            auto changedEnd = std::lower_bound(changeLog_.begin(), changeLog_.end(), upTo, byTick);
+            changeLogBase_ += static_cast<uint32_t>(changedEnd - changeLog_.begin());
+            changeLog_.erase(changeLog_.begin(), changedEnd);
+
+            auto removedEnd = std::lower_bound(removedLog_.begin(), removedLog_.end(), upTo, byTick);
+            removedLog_.erase(removedLog_.begin(), removedEnd);
+
+            compactChangeLog();
+        }
+
+        size_t getChangeLogSize() const { return changeLog_.size(); }
+
         // ========================================================================
         // ITERATION - Cache-friendly access to all components
         // ========================================================================
@@ -106,38 +562,188 @@ namespace libre {
         // Iterate over all components with entity ID
         template<typename Func>
         void forEach(Func&& func) {
-            for (size_t i = 0; i < components_.size(); ++i) {
-                func(entities_[i], components_[i]);
-            }
+            forEachImpl(*this, func);
         }
 
         template<typename Func>
         void forEach(Func&& func) const {
-            for (size_t i = 0; i < components_.size(); ++i) {
-                func(entities_[i], components_[i]);
-            }
+            forEachImpl(*this, func);
         }
 
-        // Direct access to arrays (for tight loops)
-        T* data() { return components_.data(); }
-        const T* data() const { return components_.data(); }
+        // Component at a dense index (< denseSize(); check entityData() for holes)
+        T& getByIndex(size_t index) { return components_[index]; }
+        const T& getByIndex(size_t index) const { return components_[index]; }
 
-        EntityID* entityData() { return entities_.data(); }
-        const EntityID* entityData() const { return entities_.data(); }
+        // Direct access to arrays (for tight loops; dense layout only). Paged
+        // components aren't contiguous: use forEach, or getByIndex with
+        // entityData().
+        T* data() {
+            static_assert(!POINTER_STABLE, "data() needs dense storage; iterate paged storage with forEach");
+            return components_.data();
+        }
+        const T* data() const {
+            static_assert(!POINTER_STABLE, "data() needs dense storage; iterate paged storage with forEach");
+            return components_.data();
+        }
 
-        // Iterator support
-        auto begin() { return components_.begin(); }
-        auto end() { return components_.end(); }
-        auto begin() const { return components_.begin(); }
-        auto end() const { return components_.end(); }
+        EntityID* entityData() { return index_.data(); }
+        const EntityID* entityData() const { return index_.data(); }
+
+        // Iterator support (dense layout only, like data())
+        auto begin() {
+            static_assert(!POINTER_STABLE, "begin() needs dense storage; iterate paged storage with forEach");
+            return components_.begin();
+        }
+        auto end() {
+            static_assert(!POINTER_STABLE, "end() needs dense storage; iterate paged storage with forEach");
+            return components_.end();
+        }
+        auto begin() const {
+            static_assert(!POINTER_STABLE, "begin() needs dense storage; iterate paged storage with forEach");
+            return components_.begin();
+        }
+        auto end() const {
+            static_assert(!POINTER_STABLE, "end() needs dense storage; iterate paged storage with forEach");
+            return components_.end();
+        }
 
-        // Get all entities with this component
-        const std::vector<EntityID>& getEntities() const { return entities_; }
+        // Entity of each dense slot, parallel to getByIndex. Paged storage
+        // leaves INVALID_ENTITY in the slots of removed components until
+        // they're reused, so skip those (forEach does).
+        const std::vector<EntityID>& getEntities() const { return index_.dense(); }
 
     private:
-        std::vector<T> components_;                          // Dense array
-        std::vector<EntityID> entities_;                     // Parallel entity IDs
-        std::unordered_map<EntityID, size_t> entityToIndex_; // Sparse lookup
+        struct ChangeRecord {
+            EntityID entity;
+            uint32_t tick;
+        };
+
+        // Dense: one linear pass. Paged: one linear pass per page, skipping holes.
+        template<typename Self, typename Func>
+        static void forEachImpl(Self& self, Func& func) {
+            const EntityID* entities = self.index_.data();
+            size_t count = self.components_.size();
+
+            if constexpr (POINTER_STABLE) {
+                constexpr size_t PAGE = ComponentStorageTraits<T>::pageSize;
+                for (size_t first = 0; first < count; first += PAGE) {
+                    auto* page = self.components_.page(first / PAGE);
+                    size_t last = std::min(count, first + PAGE);
+                    for (size_t i = first; i < last; ++i) {
+                        if (entities[i] != INVALID_ENTITY) func(entities[i], page[i - first]);
+                    }
+                }
+            }
+            else {
+                auto* components = self.components_.data();
+                for (size_t i = 0; i < count; ++i) {
+                    func(entities[i], components[i]);
+                }
+            }
+        }
+
+        // New entity: reuse a hole (paged layout) or append
+        template<typename... Args>
+        uint32_t insertNew(EntityID entity, const ComponentTicks& ticks, Args&&... args) {
+            if (POINTER_STABLE && !holes_.empty()) {
+                uint32_t index = holes_.back();
+                holes_.pop_back();
+                index_.insertAt(index, entity);
+                detail::assignComponent(components_[index], std::forward<Args>(args)...);
+                ticks_[index] = ticks;
+                return index;
+            }
+
+            uint32_t index = index_.insert(entity);
+            components_.emplace_back(std::forward<Args>(args)...);
+            ticks_.push_back(ticks);
+            return index;
+        }
+
+        void removeAt(uint32_t index, uint32_t tick) {
+            EntityID entity = index_.dense()[index];
+
+            if constexpr (POINTER_STABLE) {
+                // Leave a hole so no other component moves
+                components_[index] = T{};
+                ticks_[index] = ComponentTicks{};
+                index_.tombstone(index);
+                holes_.push_back(index);
+                removedLog_.push_back({ entity, tick });
+                return;
+            }
+
+            size_t lastIndex = components_.size() - 1;
+            if (index != lastIndex) {
+                // Swap with last element
+                components_[index] = std::move(components_[lastIndex]);
+                ticks_[index] = ticks_[lastIndex];
+            }
+
+            components_.pop_back();
+            ticks_.pop_back();
+            index_.swapRemove(index);
+
+            removedLog_.push_back({ entity, tick });
+        }
+
+        // Stamp slot and log it (once per tick)
+        void touch(uint32_t index) {
+            uint32_t tick = getChangeTick();
+            ComponentTicks& ticks = ticks_[index];
+            if (ticks.changed == tick && ticks.logIndex >= changeLogBase_) {
+                return;
+            }
+
+            ticks.changed = tick;
+            ticks.logIndex = changeLogBase_ + static_cast<uint32_t>(changeLog_.size());
+            changeLog_.push_back({ index_.data()[index], tick });
+        }
+
+        // Visit dense index of every slot whose latest log entry is newer than
+        // 'since'. Entries appended by the callback are not visited.
+        template<typename Visit>
+        void visitChangeLog(uint32_t since, Visit&& visit) {
+            auto first = std::upper_bound(changeLog_.begin(), changeLog_.end(), since,
+                [](uint32_t tick, const ChangeRecord& record) { return tick < record.tick; });
+
+            size_t begin = static_cast<size_t>(first - changeLog_.begin());
+            size_t end = changeLog_.size();
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t index = index_.find(changeLog_[i].entity);
+                if (index == EntitySparseSet::NPOS) continue;
+
+                // Skip entries superseded by a later write
+                if (ticks_[index].logIndex != changeLogBase_ + i) continue;
+                visit(index);
+            }
+        }
+
+        // Drop superseded change log entries once they dominate the log
+        void compactChangeLog() {
+            if (changeLog_.size() < 64 || changeLog_.size() < components_.size() * 2) return;
+
+            size_t kept = 0;
+            for (size_t i = 0; i < changeLog_.size(); ++i) {
+                uint32_t index = index_.find(changeLog_[i].entity);
+                if (index == EntitySparseSet::NPOS) continue;
+                if (ticks_[index].logIndex != changeLogBase_ + i) continue;
+
+                // Survivors are each slot's latest entry; renumber in place
+                ticks_[index].logIndex = changeLogBase_ + static_cast<uint32_t>(kept);
+                changeLog_[kept++] = changeLog_[i];
+            }
+            changeLog_.resize(kept);
+        }
+
+        Container components_;          // Dense array (or pages, see traits)
+        std::vector<ComponentTicks> ticks_;   // Parallel to components_
+        std::vector<uint32_t> holes_;   // Free dense slots (pointer-stable layout only)
+        EntitySparseSet index_;         // Parallel entity IDs + paged sparse lookup
+
+        std::vector<ChangeRecord> changeLog_;     // Ordered by tick
+        std::vector<ChangeRecord> removedLog_;    // Ordered by tick
+        uint32_t changeLogBase_ = 0;              // Absolute index of changeLog_[0]
     };
 
     // ============================================================================
@@ -159,30 +765,27 @@ namespace libre {
 
         // Add position
         void add(EntityID entity, float px, float py, float pz) {
-            auto it = entityToIndex_.find(entity);
+            uint32_t idx = index_.findSlot(entity);
 
-            if (it != entityToIndex_.end()) {
-                size_t idx = it->second;
+            if (idx != EntitySparseSet::NPOS) {
+                index_.rebind(idx, entity);
                 x_[idx] = px;
                 y_[idx] = py;
                 z_[idx] = pz;
                 return;
             }
 
-            size_t index = x_.size();
+            index_.insert(entity);
             x_.push_back(px);
             y_.push_back(py);
             z_.push_back(pz);
-            entities_.push_back(entity);
-            entityToIndex_[entity] = index;
         }
 
         // Get position
         bool get(EntityID entity, float& px, float& py, float& pz) const {
-            auto it = entityToIndex_.find(entity);
-            if (it == entityToIndex_.end()) return false;
+            uint32_t idx = index_.find(entity);
+            if (idx == EntitySparseSet::NPOS) return false;
 
-            size_t idx = it->second;
             px = x_[idx];
             py = y_[idx];
             pz = z_[idx];
@@ -190,47 +793,60 @@ namespace libre {
         }
 
         bool has(EntityID entity) const override {
-            return entityToIndex_.find(entity) != entityToIndex_.end();
+            return index_.contains(entity);
         }
 
         void remove(EntityID entity) override {
-            auto it = entityToIndex_.find(entity);
-            if (it == entityToIndex_.end()) return;
+            uint32_t index = index_.find(entity);
+            if (index == EntitySparseSet::NPOS) return;
 
-            size_t index = it->second;
             size_t lastIndex = x_.size() - 1;
-
             if (index != lastIndex) {
                 x_[index] = x_[lastIndex];
                 y_[index] = y_[lastIndex];
                 z_[index] = z_[lastIndex];
-                entities_[index] = entities_[lastIndex];
-                entityToIndex_[entities_[index]] = index;
             }
 
             x_.pop_back();
             y_.pop_back();
             z_.pop_back();
-            entities_.pop_back();
-            entityToIndex_.erase(entity);
+            index_.swapRemove(index);
         }
 
         void clear() override {
             x_.clear();
             y_.clear();
             z_.clear();
-            entities_.clear();
-            entityToIndex_.clear();
+            index_.clear();
         }
 
         size_t size() const override { return x_.size(); }
 
-        const std::vector<EntityID>& getEntities() const { return entities_; }
+        ComponentMemory getMemoryUsage() const override {
+            ComponentMemory memory;
+            memory.components = vectorMemory(x_);
+            memory.components += vectorMemory(y_);
+            memory.components += vectorMemory(z_);
+            memory.index = index_.getMemoryUsage(size());
+            return memory;
+        }
+
+        void shrinkToFit() override {
+            x_.shrink_to_fit();
+            y_.shrink_to_fit();
+            z_.shrink_to_fit();
+            index_.shrinkToFit();
+        }
+
+        const char* getTypeName() const override { return typeid(T).name(); }
+
+        uint32_t indexOf(EntityID entity) const { return index_.find(entity); }
+
+        const std::vector<EntityID>& getEntities() const { return index_.dense(); }
 
     private:
         std::vector<float> x_, y_, z_;
-        std::vector<EntityID> entities_;
-        std::unordered_map<EntityID, size_t> entityToIndex_;
+        EntitySparseSet index_;
     };
 
 } // namespace libre
\ No newline at end of file
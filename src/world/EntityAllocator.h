@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+
+namespace libre {
+
+    // ============================================================================
+    // ENTITY ALLOCATOR - Generation-checked IDs with index recycling
+    // ============================================================================
+    // One 32-bit generation per index. A dead slot has DEAD_BIT set, and issued
+    // IDs never have it, so liveness is a single compare. Destroying an entity
+    // bumps the generation and pushes the index on a free list, so index space
+    // only grows to the peak number of live entities. Slots whose generation
+    // would overflow are retired instead of being recycled.
+    //
+    // Live IDs are also kept in a dense array (swap-remove) for iteration.
+
+    class EntityAllocator {
+    public:
+        static constexpr uint32_t DEAD_BIT = 0x80000000u;
+        static constexpr uint32_t MAX_GENERATION = DEAD_BIT - 1;
+        static constexpr uint32_t NPOS = 0xFFFFFFFF;
+
+        EntityAllocator() {
+            // Index 0 is reserved so that INVALID_ENTITY is never alive
+            generations_.push_back(DEAD_BIT);
+            denseIndex_.push_back(NPOS);
+        }
+
+        EntityID create() {
+            uint32_t index;
+            if (!freeList_.empty()) {
+                index = freeList_.back();
+                freeList_.pop_back();
+                generations_[index] &= ~DEAD_BIT;
+            }
+            else {
+                index = static_cast<uint32_t>(generations_.size());
+                generations_.push_back(0);
+                denseIndex_.push_back(NPOS);
+            }
+
+            EntityID id = makeEntityID(index, generations_[index]);
+            denseIndex_[index] = static_cast<uint32_t>(alive_.size());
+            alive_.push_back(id);
+            return id;
+        }
+
+        // Create 'count' entities into out[0..count). Recycled indices are
+        // used first, then fresh ones (which are consecutive).
+        void create(size_t count, EntityID* out) {
+            size_t fresh = count > freeList_.size() ? count - freeList_.size() : 0;
+            reserveMore(generations_, fresh);
+            reserveMore(denseIndex_, fresh);
+            reserveMore(alive_, count);
+
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = create();
+            }
+        }
+
+        // Returns false if the ID was not alive
+        bool destroy(EntityID id) {
+            if (!isAlive(id)) return false;
+
+            uint32_t index = getEntityIndex(id);
+
+            // Swap-remove from dense list
+            uint32_t dense = denseIndex_[index];
+            EntityID last = alive_.back();
+            alive_[dense] = last;
+            denseIndex_[getEntityIndex(last)] = dense;
+            alive_.pop_back();
+            denseIndex_[index] = NPOS;
+
+            uint32_t generation = generations_[index];
+            if (generation < MAX_GENERATION) {
+                generations_[index] = (generation + 1) | DEAD_BIT;
+                freeList_.push_back(index);
+            }
+            else {
+                generations_[index] = MAX_GENERATION | DEAD_BIT;  // Retired
+            }
+            return true;
+        }
+
+        bool isAlive(EntityID id) const {
+            uint32_t index = getEntityIndex(id);
+            return index < generations_.size() && generations_[index] == getEntityGeneration(id);
+        }
+
+        // Destroy every live entity (generations still advance, so old
+        // handles stay invalid after a clear)
+        void clear() {
+            while (!alive_.empty()) {
+                destroy(alive_.back());
+            }
+        }
+
+        size_t size() const { return alive_.size(); }
+
+        // Number of indices ever handed out (including index 0)
+        size_t capacity() const { return generations_.size(); }
+        size_t freeCount() const { return freeList_.size(); }
+
+        // Dense list of live entities (order changes on destroy)
+        const std::vector<EntityID>& alive() const { return alive_; }
+
+        // Per-index tables are never shrunk: every index ever issued keeps
+        // its generation so stale handles stay invalid
+        MemoryUsage getMemoryUsage() const {
+            MemoryUsage usage = vectorMemory(generations_);
+            usage += vectorMemory(denseIndex_);
+            usage += vectorMemory(freeList_);
+            usage += vectorMemory(alive_);
+            return usage;
+        }
+
+        void shrinkToFit() {
+            freeList_.shrink_to_fit();
+            alive_.shrink_to_fit();
+        }
+
+    private:
+        std::vector<uint32_t> generations_;   // Per index; DEAD_BIT when free
+        std::vector<uint32_t> denseIndex_;    // Per index: position in alive_
+        std::vector<uint32_t> freeList_;      // Recyclable indices
+        std::vector<EntityID> alive_;         // Dense live IDs
+    };
+
+} // namespace libre
@@ -0,0 +1,345 @@
+#include "HierarchyStore.h"
+#include <cassert>
+
+namespace libre {
+
+    // ============================================================================
+    // MEMBERSHIP
+    // ============================================================================
+
+    void HierarchyStore::insert(EntityID entity) {
+        insert(&entity, 1);
+    }
+
+    void HierarchyStore::insert(const EntityID* entities, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t index = getEntityIndex(entities[i]);
+            if (index >= ids_.size()) {
+                ids_.resize(static_cast<size_t>(index) + 1, INVALID_ENTITY);
+                nodes_.resize(ids_.size());
+                labels_.resize(ids_.size());
+            }
+            if (ids_[index] == entities[i]) continue;
+            assert(ids_[index] == INVALID_ENTITY && "stale entity still in the hierarchy");
+
+            ids_[index] = entities[i];
+            nodes_[index] = Node{};
+            addRoot(index);
+            ++count_;
+
+            // New roots go at the end of the tour; labels stay current
+            if (!labelsDirty_) {
+                uint32_t pos = static_cast<uint32_t>(tour_.size());
+                labels_[index] = { pos, pos + 1 };
+                tour_.push_back(entities[i]);
+            }
+        }
+    }
+
+    void HierarchyStore::erase(const EntityID* entities, size_t count) {
+        std::vector<uint32_t> doomed;
+        doomed.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t index = indexOf(entities[i]);
+            if (index == NONE) continue;
+            doomed.push_back(index);
+
+            // Marks it dead for the passes below
+            ids_[index] = INVALID_ENTITY;
+        }
+
+        for (uint32_t index : doomed) {
+            Node& node = nodes_[index];
+
+            // Only surviving parents need their child lists patched
+            if (node.parent != NONE) {
+                if (ids_[node.parent] != INVALID_ENTITY) unlinkFromParent(index);
+            }
+            else {
+                removeRoot(index);
+            }
+
+            // Leaves a hole; everyone else's interval still holds
+            if (!labelsDirty_) tour_[labels_[index].enter] = INVALID_ENTITY;
+
+            // Surviving children become roots
+            uint32_t child = node.firstChild;
+            while (child != NONE) {
+                uint32_t next = nodes_[child].nextSibling;
+                if (ids_[child] != INVALID_ENTITY) {
+                    labelsDirty_ = true;
+                    Node& c = nodes_[child];
+                    c.parent = NONE;
+                    c.prevSibling = NONE;
+                    c.nextSibling = NONE;
+                    c.depth = 0;
+                    addRoot(child);
+                    refreshDepths(child);
+                }
+                child = next;
+            }
+        }
+
+        for (uint32_t index : doomed) {
+            nodes_[index] = Node{};
+            labels_[index] = Interval{};
+        }
+        count_ -= doomed.size();
+    }
+
+    // ============================================================================
+    // STRUCTURE
+    // ============================================================================
+
+    bool HierarchyStore::setParent(EntityID child, EntityID parent) {
+        uint32_t c = indexOf(child);
+        if (c == NONE) return false;
+
+        uint32_t p = NONE;
+        if (parent != INVALID_ENTITY) {
+            p = indexOf(parent);
+            if (p == NONE) return false;
+            if (p == c || isAncestorIndex(c, p)) return false;
+        }
+        if (nodes_[c].parent == p) return true;
+        labelsDirty_ = true;
+
+        if (nodes_[c].parent != NONE) unlinkFromParent(c);
+        else removeRoot(c);
+
+        uint32_t depth = 0;
+        if (p != NONE) {
+            appendChild(p, c);
+            depth = nodes_[p].depth + 1;
+        }
+        else {
+            addRoot(c);
+        }
+
+        if (nodes_[c].depth != depth) {
+            nodes_[c].depth = depth;
+            refreshDepths(c);
+        }
+        return true;
+    }
+
+    bool HierarchyStore::isAncestorOf(EntityID ancestor, EntityID descendant) const {
+        uint32_t a = indexOf(ancestor);
+        uint32_t d = indexOf(descendant);
+        if (a == NONE || d == NONE) return false;
+        return isAncestorIndex(a, d);
+    }
+
+    bool HierarchyStore::isAncestorIndex(uint32_t a, uint32_t d) const {
+        if (!labelsDirty_) {
+            return labels_[a].enter < labels_[d].enter && labels_[d].enter < labels_[a].exit;
+        }
+        if (nodes_[a].firstChild == NONE || nodes_[a].depth >= nodes_[d].depth) return false;
+
+        // Climb to the ancestor's depth, then compare once
+        while (nodes_[d].depth > nodes_[a].depth) {
+            d = nodes_[d].parent;
+        }
+        return d == a;
+    }
+
+    void HierarchyStore::updateIntervals() {
+        // Holes cost scan time in forEachDescendant; compact when they dominate
+        if (labelsDirty_ || tour_.size() > 2 * count_ + 64) relabel();
+    }
+
+    void HierarchyStore::clear() {
+        ids_.clear();
+        nodes_.clear();
+        roots_.clear();
+        count_ = 0;
+
+        labels_.clear();
+        tour_.clear();
+        labelsDirty_ = false;
+    }
+
+    MemoryUsage HierarchyStore::getMemoryUsage() const {
+        // Unused index slots are allocated but hold nothing
+        size_t unused = ids_.size() - count_;
+
+        MemoryUsage usage = vectorMemory(ids_);
+        usage += vectorMemory(nodes_);
+        usage += vectorMemory(labels_);
+        usage.used -= unused * (sizeof(EntityID) + sizeof(Node) + sizeof(Interval));
+        usage += vectorMemory(roots_);
+        usage += vectorMemory(tour_);
+        return usage;
+    }
+
+    void HierarchyStore::shrinkToFit() {
+        size_t count = ids_.size();
+        while (count > 0 && ids_[count - 1] == INVALID_ENTITY) {
+            --count;
+        }
+        ids_.resize(count);
+        nodes_.resize(count);
+        labels_.resize(count);
+
+        // Compacts the tour as well
+        relabel();
+
+        ids_.shrink_to_fit();
+        nodes_.shrink_to_fit();
+        labels_.shrink_to_fit();
+        roots_.shrink_to_fit();
+        tour_.shrink_to_fit();
+    }
+
+    // ============================================================================
+    // WALKER
+    // ============================================================================
+
+    HierarchyWalker& HierarchyWalker::start(const EntityID* roots, size_t count, Order order, bool includeRoots) {
+        order_ = order;
+        includeRoots_ = includeRoots;
+        skip_ = false;
+        current_ = NONE;
+
+        if (order == Order::DepthFirst) {
+            roots_ = roots;
+            rootCount_ = count;
+            rootPos_ = 0;
+            nextRoot();
+            return *this;
+        }
+
+        // Seed the frontier with the roots (or their children)
+        queue_.clear();
+        head_ = 0;
+        const Node* nodes = store_->nodes_.data();
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t index = store_->indexOf(roots[i]);
+            if (index == NONE) continue;
+            if (includeRoots) {
+                queue_.push_back(index);
+                continue;
+            }
+            for (uint32_t child = nodes[index].firstChild; child != NONE; child = nodes[child].nextSibling) {
+                queue_.push_back(child);
+            }
+        }
+        if (head_ < queue_.size()) current_ = queue_[head_++];
+        return *this;
+    }
+
+    void HierarchyWalker::nextRoot() {
+        const Node* nodes = store_->nodes_.data();
+        current_ = NONE;
+        root_ = NONE;
+
+        while (rootPos_ < rootCount_) {
+            uint32_t index = store_->indexOf(roots_[rootPos_++]);
+            if (index == NONE) continue;
+
+            // Without the root itself, its subtree starts at the first child
+            uint32_t first = includeRoots_ ? index : nodes[index].firstChild;
+            if (first == NONE) continue;
+
+            root_ = index;
+            current_ = first;
+            return;
+        }
+    }
+
+    // ============================================================================
+    // INTERNALS
+    // ============================================================================
+
+    void HierarchyStore::addRoot(uint32_t index) {
+        nodes_[index].rootSlot = static_cast<uint32_t>(roots_.size());
+        roots_.push_back(ids_[index]);
+    }
+
+    void HierarchyStore::removeRoot(uint32_t index) {
+        uint32_t slot = nodes_[index].rootSlot;
+        EntityID moved = roots_.back();
+        roots_[slot] = moved;
+        roots_.pop_back();
+        nodes_[getEntityIndex(moved)].rootSlot = slot;
+        nodes_[index].rootSlot = NONE;
+    }
+
+    void HierarchyStore::unlinkFromParent(uint32_t index) {
+        Node& node = nodes_[index];
+        Node& parent = nodes_[node.parent];
+
+        if (node.prevSibling != NONE) nodes_[node.prevSibling].nextSibling = node.nextSibling;
+        else parent.firstChild = node.nextSibling;
+        if (node.nextSibling != NONE) nodes_[node.nextSibling].prevSibling = node.prevSibling;
+        else parent.lastChild = node.prevSibling;
+        --parent.childCount;
+
+        node.parent = NONE;
+        node.prevSibling = NONE;
+        node.nextSibling = NONE;
+    }
+
+    void HierarchyStore::appendChild(uint32_t parent, uint32_t child) {
+        Node& p = nodes_[parent];
+        Node& c = nodes_[child];
+
+        c.parent = parent;
+        c.prevSibling = p.lastChild;
+        c.nextSibling = NONE;
+        if (p.lastChild != NONE) nodes_[p.lastChild].nextSibling = child;
+        else p.firstChild = child;
+        p.lastChild = child;
+        ++p.childCount;
+    }
+
+    void HierarchyStore::refreshDepths(uint32_t root) {
+        uint32_t index = nodes_[root].firstChild;
+        while (index != NONE && index != root) {
+            nodes_[index].depth = nodes_[nodes_[index].parent].depth + 1;
+
+            if (nodes_[index].firstChild != NONE) {
+                index = nodes_[index].firstChild;
+                continue;
+            }
+            while (index != root && nodes_[index].nextSibling == NONE) {
+                index = nodes_[index].parent;
+            }
+            if (index != root) index = nodes_[index].nextSibling;
+        }
+    }
+
+    void HierarchyStore::relabel() {
+        tour_.clear();
+        tour_.reserve(count_);
+
+        // Stackless pre-order per root; exit is set on the way back up
+        for (EntityID rootId : roots_) {
+            uint32_t root = getEntityIndex(rootId);
+            uint32_t index = root;
+            while (true) {
+                labels_[index].enter = static_cast<uint32_t>(tour_.size());
+                tour_.push_back(ids_[index]);
+
+                if (nodes_[index].firstChild != NONE) {
+                    index = nodes_[index].firstChild;
+                    continue;
+                }
+
+                while (true) {
+                    labels_[index].exit = static_cast<uint32_t>(tour_.size());
+                    if (index == root) break;
+                    if (nodes_[index].nextSibling != NONE) {
+                        index = nodes_[index].nextSibling;
+                        break;
+                    }
+                    index = nodes_[index].parent;
+                }
+                if (index == root) break;
+            }
+        }
+
+        labelsDirty_ = false;
+    }
+
+} // namespace libre
@@ -0,0 +1,391 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+#include <iterator>
+
+namespace libre {
+
+    // ============================================================================
+    // HIERARCHY STORE - Scene parent/child forest in flat arrays
+    // ============================================================================
+    // One Node per entity index: parent, first/last child, prev/next sibling,
+    // child count and depth, all as entity indices (NONE = none). Children
+    // keep insertion order. Roots are kept in a dense list (swap-remove), so
+    // getRoots() needs no scan. Lookups are O(1), children() walks the
+    // sibling chain without allocating, and reparenting costs O(subtree)
+    // for the depth update.
+    //
+    // Every live entity is in the store; World inserts on create and erases
+    // on destroy. setParent() refuses cycles.
+    //
+    // Interval index: a pre-order tour of the forest gives every entity an
+    // interval [enter, exit) that contains exactly its descendants' enter
+    // positions. While the labels are current, isAncestorOf() is two integer
+    // compares and forEachDescendant() scans a contiguous slice of the tour.
+    // New roots are appended and erased entities leave holes, so only
+    // reparenting invalidates the labels. Relabeling is lazy: one O(n)
+    // rebuild in updateIntervals() at the next sync point covers every
+    // reparent since the last one, and until then queries fall back to the
+    // parent and sibling links.
+    //
+    // For walks that need pruning or breadth-first order, see HierarchyWalker
+    // below.
+
+    class HierarchyWalker;
+
+    class HierarchyStore {
+    public:
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+        // Children of one entity, first to last; yields EntityID
+        class ChildRange {
+        public:
+            class iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = EntityID;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const EntityID*;
+                using reference = EntityID;
+
+                iterator(const HierarchyStore* store, uint32_t index) : store_(store), index_(index) {}
+
+                EntityID operator*() const { return store_->ids_[index_]; }
+                iterator& operator++() {
+                    index_ = store_->nodes_[index_].nextSibling;
+                    return *this;
+                }
+                iterator operator++(int) {
+                    iterator old = *this;
+                    ++*this;
+                    return old;
+                }
+
+                bool operator==(const iterator& other) const { return index_ == other.index_; }
+                bool operator!=(const iterator& other) const { return index_ != other.index_; }
+
+            private:
+                const HierarchyStore* store_;
+                uint32_t index_;
+            };
+
+            ChildRange(const HierarchyStore* store, uint32_t first, uint32_t count)
+                : store_(store), first_(first), count_(count) {
+            }
+
+            iterator begin() const { return iterator(store_, first_); }
+            iterator end() const { return iterator(store_, NONE); }
+            size_t size() const { return count_; }
+            bool empty() const { return count_ == 0; }
+
+        private:
+            const HierarchyStore* store_;
+            uint32_t first_;
+            uint32_t count_;
+        };
+
+        // ========================================================================
+        // MEMBERSHIP
+        // ========================================================================
+
+        // Add entities as roots
+        void insert(EntityID entity);
+        void insert(const EntityID* entities, size_t count);
+
+        // Remove entities. Survivors whose parent is removed become roots;
+        // when the batch is closed under descendants (World's destroy
+        // cascade) nothing is re-rooted and the cost is O(count).
+        void erase(const EntityID* entities, size_t count);
+        void erase(EntityID entity) { erase(&entity, 1); }
+
+        bool contains(EntityID entity) const { return indexOf(entity) != NONE; }
+
+        // ========================================================================
+        // STRUCTURE
+        // ========================================================================
+
+        // Make 'child' the last child of 'parent' (INVALID_ENTITY: a root).
+        // Returns false if either is unknown or the move would form a cycle.
+        bool setParent(EntityID child, EntityID parent);
+
+        EntityID getParent(EntityID entity) const { return link(entity, &Node::parent); }
+        EntityID getFirstChild(EntityID entity) const { return link(entity, &Node::firstChild); }
+        EntityID getLastChild(EntityID entity) const { return link(entity, &Node::lastChild); }
+        EntityID getNextSibling(EntityID entity) const { return link(entity, &Node::nextSibling); }
+        EntityID getPrevSibling(EntityID entity) const { return link(entity, &Node::prevSibling); }
+
+        ChildRange children(EntityID entity) const {
+            uint32_t index = indexOf(entity);
+            if (index == NONE) return ChildRange(this, NONE, 0);
+            return ChildRange(this, nodes_[index].firstChild, nodes_[index].childCount);
+        }
+
+        size_t getChildCount(EntityID entity) const {
+            uint32_t index = indexOf(entity);
+            return index != NONE ? nodes_[index].childCount : 0;
+        }
+
+        // Roots are depth 0
+        uint32_t getDepth(EntityID entity) const {
+            uint32_t index = indexOf(entity);
+            return index != NONE ? nodes_[index].depth : 0;
+        }
+
+        // Order changes when roots are parented or erased
+        const std::vector<EntityID>& getRoots() const { return roots_; }
+
+        // Strict: an entity is not its own ancestor. Two compares with current
+        // labels, else O(depth difference).
+        bool isAncestorOf(EntityID ancestor, EntityID descendant) const;
+
+        // Pre-order over the subtree below 'entity' (excluding it):
+        // func(EntityID, uint32_t depth). A range scan of the tour with
+        // current labels, else a walk along the sibling links; neither
+        // allocates.
+        template<typename Func>
+        void forEachDescendant(EntityID entity, Func&& func) const {
+            uint32_t root = indexOf(entity);
+            if (root == NONE || nodes_[root].firstChild == NONE) return;
+
+            if (!labelsDirty_) {
+                const Interval& span = labels_[root];
+                for (uint32_t pos = span.enter + 1; pos < span.exit; ++pos) {
+                    EntityID id = tour_[pos];
+                    if (id != INVALID_ENTITY) func(id, nodes_[getEntityIndex(id)].depth);
+                }
+                return;
+            }
+
+            uint32_t index = nodes_[root].firstChild;
+            while (index != root) {
+                func(ids_[index], nodes_[index].depth);
+
+                if (nodes_[index].firstChild != NONE) {
+                    index = nodes_[index].firstChild;
+                    continue;
+                }
+                while (index != root && nodes_[index].nextSibling == NONE) {
+                    index = nodes_[index].parent;
+                }
+                if (index != root) index = nodes_[index].nextSibling;
+            }
+        }
+
+        // Rebuild the interval labels if a reparent invalidated them (or
+        // erased entities left the tour mostly holes). Not thread-safe;
+        // call where nothing reads the hierarchy.
+        void updateIntervals();
+        bool intervalsCurrent() const { return !labelsDirty_; }
+
+        void clear();
+        size_t size() const { return count_; }
+
+        MemoryUsage getMemoryUsage() const;
+
+        // Drop unused trailing index slots
+        void shrinkToFit();
+
+    private:
+        friend class HierarchyWalker;
+
+        struct Node {
+            uint32_t parent = NONE;
+            uint32_t firstChild = NONE;
+            uint32_t lastChild = NONE;
+            uint32_t nextSibling = NONE;
+            uint32_t prevSibling = NONE;
+            uint32_t childCount = 0;
+            uint32_t depth = 0;
+            uint32_t rootSlot = NONE;       // Position in roots_ (NONE if parented)
+        };
+
+        // Tour positions; descendants have enter in (enter, exit)
+        struct Interval {
+            uint32_t enter = 0;
+            uint32_t exit = 0;
+        };
+
+        uint32_t indexOf(EntityID entity) const {
+            uint32_t index = getEntityIndex(entity);
+            if (index >= ids_.size() || ids_[index] != entity || entity == INVALID_ENTITY) return NONE;
+            return index;
+        }
+
+        EntityID link(EntityID entity, uint32_t Node::* field) const {
+            uint32_t index = indexOf(entity);
+            if (index == NONE) return INVALID_ENTITY;
+            uint32_t other = nodes_[index].*field;
+            return other != NONE ? ids_[other] : INVALID_ENTITY;
+        }
+
+        void addRoot(uint32_t index);
+        void removeRoot(uint32_t index);
+        void unlinkFromParent(uint32_t index);
+        void appendChild(uint32_t parent, uint32_t child);
+
+        // Depths below 'index' after its own depth changed
+        void refreshDepths(uint32_t index);
+
+        bool isAncestorIndex(uint32_t ancestor, uint32_t descendant) const;
+        void relabel();
+
+        std::vector<EntityID> ids_;         // By entity index; INVALID_ENTITY if unused
+        std::vector<Node> nodes_;           // Parallel to ids_
+        std::vector<EntityID> roots_;
+        size_t count_ = 0;
+
+        std::vector<Interval> labels_;      // Parallel to ids_
+        std::vector<EntityID> tour_;        // Pre-order; INVALID_ENTITY where erased
+        bool labelsDirty_ = false;
+    };
+
+    // ============================================================================
+    // HIERARCHY WALKER - Iterative depth- or breadth-first subtree walk
+    // ============================================================================
+    // A cursor over one or more subtrees of a HierarchyStore. Depth-first
+    // order follows the parent and sibling links and needs no stack at all;
+    // breadth-first order keeps its frontier in a queue owned by the walker,
+    // which is reused by the next walk, so a walker kept around performs no
+    // allocations once warmed up. Neither recurses, so a 100k-deep chain is
+    // fine.
+    //
+    // skipChildren() prunes the subtree below the current entity. Don't
+    // change the hierarchy during a walk.
+    //
+    //     HierarchyWalker walk(world.getHierarchy());
+    //     for (EntityID id : walk.depthFirst(root)) {
+    //         if (isHidden(id)) walk.skipChildren();
+    //         else draw(id, walk.depth());
+    //     }
+
+    class HierarchyWalker {
+    public:
+        enum class Order : uint8_t { DepthFirst, BreadthFirst };
+
+        // Input iterator; advancing it advances the walker
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = EntityID;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const EntityID*;
+            using reference = EntityID;
+
+            explicit iterator(HierarchyWalker* walker) : walker_(walker) {}
+
+            EntityID operator*() const { return walker_->entity(); }
+            iterator& operator++() {
+                walker_->next();
+                return *this;
+            }
+
+            // Only compares against end()
+            bool operator==(const iterator& other) const { return done() == other.done(); }
+            bool operator!=(const iterator& other) const { return done() != other.done(); }
+
+        private:
+            bool done() const { return !walker_ || walker_->done(); }
+
+            HierarchyWalker* walker_;
+        };
+
+        explicit HierarchyWalker(const HierarchyStore& store) : store_(&store) {}
+
+        // Walk the subtree at 'root', root first. An unknown root is an
+        // empty walk.
+        HierarchyWalker& depthFirst(EntityID root, bool includeRoot = true) {
+            single_ = root;
+            return start(&single_, 1, Order::DepthFirst, includeRoot);
+        }
+        HierarchyWalker& breadthFirst(EntityID root, bool includeRoot = true) {
+            single_ = root;
+            return start(&single_, 1, Order::BreadthFirst, includeRoot);
+        }
+
+        // Walk the whole forest, root by root
+        HierarchyWalker& all(Order order = Order::DepthFirst) {
+            const auto& roots = store_->getRoots();
+            return start(roots.data(), roots.size(), order, true);
+        }
+
+        // Walk several subtrees in turn. Subtrees must not overlap. 'roots'
+        // must outlive the walk.
+        HierarchyWalker& start(const EntityID* roots, size_t count, Order order, bool includeRoots = true);
+
+        bool done() const { return current_ == HierarchyStore::NONE; }
+        EntityID entity() const { return store_->ids_[current_]; }
+
+        // Absolute depth; roots of the forest are 0
+        uint32_t depth() const { return store_->nodes_[current_].depth; }
+
+        // Don't descend below the current entity
+        void skipChildren() { skip_ = true; }
+
+        void next() {
+            if (order_ == Order::DepthFirst) nextDepthFirst();
+            else nextBreadthFirst();
+        }
+
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(nullptr); }
+
+    private:
+        using Node = HierarchyStore::Node;
+        static constexpr uint32_t NONE = HierarchyStore::NONE;
+
+        void nextDepthFirst() {
+            const Node* nodes = store_->nodes_.data();
+            bool descend = !skip_;
+            skip_ = false;
+
+            if (descend && nodes[current_].firstChild != NONE) {
+                current_ = nodes[current_].firstChild;
+                return;
+            }
+
+            // Climb until there's a sibling, stopping at the walk's root
+            while (current_ != root_ && nodes[current_].nextSibling == NONE) {
+                current_ = nodes[current_].parent;
+            }
+            if (current_ != root_) {
+                current_ = nodes[current_].nextSibling;
+                return;
+            }
+            nextRoot();
+        }
+
+        void nextBreadthFirst() {
+            const Node* nodes = store_->nodes_.data();
+            if (!skip_) {
+                for (uint32_t child = nodes[current_].firstChild; child != NONE; child = nodes[child].nextSibling) {
+                    queue_.push_back(child);
+                }
+            }
+            skip_ = false;
+
+            current_ = head_ < queue_.size() ? queue_[head_++] : NONE;
+        }
+
+        // Depth-first: move on to the next subtree, or finish
+        void nextRoot();
+
+        const HierarchyStore* store_;
+        Order order_ = Order::DepthFirst;
+        uint32_t current_ = NONE;
+        bool skip_ = false;
+        bool includeRoots_ = true;
+        EntityID single_ = INVALID_ENTITY;  // Root storage for one-subtree walks
+
+        // Depth-first state
+        const EntityID* roots_ = nullptr;
+        size_t rootCount_ = 0;
+        size_t rootPos_ = 0;
+        uint32_t root_ = NONE;              // Subtree being walked
+
+        // Breadth-first frontier; capacity carries over between walks
+        std::vector<uint32_t> queue_;
+        size_t head_ = 0;
+    };
+
+} // namespace libre
@@ -0,0 +1,462 @@
+#include "MetadataStore.h"
+#include <algorithm>
+
+namespace libre {
+
+    // ============================================================================
+    // SYMBOL TABLE
+    // ============================================================================
+
+    SymbolTable::SymbolTable() {
+        clear();
+    }
+
+    Symbol SymbolTable::intern(std::string_view str) {
+        if (str.empty()) return EMPTY_SYMBOL;
+
+        auto it = lookup_.find(str);
+        if (it != lookup_.end()) {
+            ++refCounts_[it->second];
+            return it->second;
+        }
+
+        Symbol symbol;
+        if (!freeList_.empty()) {
+            symbol = freeList_.back();
+            freeList_.pop_back();
+            strings_[symbol].assign(str.data(), str.size());
+            refCounts_[symbol] = 1;
+        }
+        else {
+            symbol = static_cast<Symbol>(strings_.size());
+            strings_.emplace_back(str);
+            refCounts_.push_back(1);
+        }
+
+        lookup_.emplace(std::string_view(strings_[symbol]), symbol);
+        return symbol;
+    }
+
+    Symbol SymbolTable::find(std::string_view str) const {
+        auto it = lookup_.find(str);
+        return it != lookup_.end() ? it->second : INVALID_SYMBOL;
+    }
+
+    void SymbolTable::retain(Symbol symbol, uint32_t count) {
+        if (symbol == EMPTY_SYMBOL || symbol >= refCounts_.size()) return;
+        refCounts_[symbol] += count;
+    }
+
+    void SymbolTable::release(Symbol symbol) {
+        // The empty string is permanent
+        if (symbol == EMPTY_SYMBOL || symbol >= refCounts_.size()) return;
+        if (refCounts_[symbol] == 0 || --refCounts_[symbol] > 0) return;
+
+        lookup_.erase(std::string_view(strings_[symbol]));
+        strings_[symbol].clear();
+        strings_[symbol].shrink_to_fit();
+        freeList_.push_back(symbol);
+    }
+
+    MemoryUsage SymbolTable::getMemoryUsage() const {
+        MemoryUsage usage;
+        size_t live = strings_.size() - freeList_.size();
+        usage.used = live * sizeof(std::string);
+        usage.reserved = strings_.size() * sizeof(std::string);
+        for (const auto& str : strings_) {
+            usage += stringMemory(str);
+        }
+        usage += vectorMemory(refCounts_);
+        usage += vectorMemory(freeList_);
+        usage += hashMemory(lookup_);
+        return usage;
+    }
+
+    void SymbolTable::shrinkToFit() {
+        refCounts_.shrink_to_fit();
+        freeList_.shrink_to_fit();
+        lookup_.rehash(0);
+    }
+
+    void SymbolTable::clear() {
+        lookup_.clear();
+        strings_.clear();
+        refCounts_.clear();
+        freeList_.clear();
+
+        strings_.emplace_back();
+        refCounts_.push_back(1);
+        lookup_.emplace(std::string_view(strings_[EMPTY_SYMBOL]), EMPTY_SYMBOL);
+    }
+
+    // ============================================================================
+    // METADATA STORE
+    // ============================================================================
+
+    uint32_t MetadataStore::slot(EntityID entity) const {
+        uint32_t index = getEntityIndex(entity);
+        if (index >= ids_.size() || ids_[index] != entity) return NONE;
+        return index;
+    }
+
+    bool MetadataStore::contains(EntityID entity) const {
+        return slot(entity) != NONE;
+    }
+
+    void MetadataStore::prepareSlot(uint32_t index) {
+        if (index >= ids_.size()) {
+            size_t count = static_cast<size_t>(index) + 1;
+            ids_.resize(count, INVALID_ENTITY);
+            names_.resize(count);
+            nameHashes_.resize(count, 0);
+            typeSymbols_.resize(count, EMPTY_SYMBOL);
+            flags_.resize(count, EntityFlags::Default);
+            layers_.resize(count, 0);
+            nameLinks_.resize(count);
+            typeLinks_.resize(count);
+        }
+        else if (ids_[index] != INVALID_ENTITY) {
+            // Stale generation still registered in this slot
+            destroy(ids_[index]);
+        }
+    }
+
+    void MetadataStore::create(EntityID entity, std::string_view name, std::string_view type) {
+        uint32_t index = getEntityIndex(entity);
+        prepareSlot(index);
+
+        ids_[index] = entity;
+        flags_[index] = EntityFlags::Default;
+        layers_[index] = 0;
+
+        names_[index].assign(name.data(), name.size());
+        nameHashes_[index] = hashName(name);
+        insertName(index);
+
+        typeSymbols_[index] = types_.intern(type);
+        linkType(index);
+    }
+
+    void MetadataStore::create(const EntityID* entities, size_t count,
+        std::string_view name, std::string_view type) {
+        if (count == 0) return;
+
+        // Size the arrays once for the highest index
+        uint32_t maxIndex = 0;
+        for (size_t i = 0; i < count; ++i) {
+            maxIndex = std::max(maxIndex, getEntityIndex(entities[i]));
+        }
+        if (maxIndex >= ids_.size()) prepareSlot(maxIndex);
+
+        uint32_t hash = hashName(name);
+        Symbol symbol = types_.intern(type);
+        types_.retain(symbol, static_cast<uint32_t>(count - 1));
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t index = getEntityIndex(entities[i]);
+            prepareSlot(index);
+
+            ids_[index] = entities[i];
+            flags_[index] = EntityFlags::Default;
+            layers_[index] = 0;
+
+            names_[index].assign(name.data(), name.size());
+            nameHashes_[index] = hash;
+            insertName(index);
+
+            typeSymbols_[index] = symbol;
+            linkType(index);
+        }
+    }
+
+    void MetadataStore::destroy(EntityID entity) {
+        uint32_t index = slot(entity);
+        if (index == NONE) return;
+
+        eraseName(index);
+        unlinkType(index);
+        types_.release(typeSymbols_[index]);
+
+        ids_[index] = INVALID_ENTITY;
+        typeSymbols_[index] = EMPTY_SYMBOL;
+        names_[index].clear();
+        names_[index].shrink_to_fit();
+    }
+
+    const std::string& MetadataStore::getName(EntityID entity) const {
+        static const std::string empty;
+        uint32_t index = slot(entity);
+        return index != NONE ? names_[index] : empty;
+    }
+
+    const std::string& MetadataStore::getType(EntityID entity) const {
+        uint32_t index = slot(entity);
+        return types_.str(index != NONE ? typeSymbols_[index] : EMPTY_SYMBOL);
+    }
+
+    void MetadataStore::setName(EntityID entity, std::string_view name) {
+        uint32_t index = slot(entity);
+        if (index == NONE) return;
+
+        eraseName(index);
+        names_[index].assign(name.data(), name.size());
+        nameHashes_[index] = hashName(name);
+        insertName(index);
+    }
+
+    void MetadataStore::setType(EntityID entity, std::string_view type) {
+        uint32_t index = slot(entity);
+        if (index == NONE) return;
+
+        Symbol symbol = types_.intern(type);
+        unlinkType(index);
+        types_.release(typeSymbols_[index]);
+        typeSymbols_[index] = symbol;
+        linkType(index);
+    }
+
+    EntityFlags MetadataStore::getFlags(EntityID entity) const {
+        uint32_t index = slot(entity);
+        return index != NONE ? flags_[index] : EntityFlags::None;
+    }
+
+    void MetadataStore::setFlags(EntityID entity, EntityFlags flags) {
+        uint32_t index = slot(entity);
+        if (index != NONE) flags_[index] = flags;
+    }
+
+    uint32_t MetadataStore::getLayer(EntityID entity) const {
+        uint32_t index = slot(entity);
+        return index != NONE ? layers_[index] : 0;
+    }
+
+    void MetadataStore::setLayer(EntityID entity, uint32_t layer) {
+        uint32_t index = slot(entity);
+        if (index != NONE) layers_[index] = layer;
+    }
+
+    Symbol MetadataStore::getTypeSymbol(EntityID entity) const {
+        uint32_t index = slot(entity);
+        return index != NONE ? typeSymbols_[index] : INVALID_SYMBOL;
+    }
+
+    MemoryUsage MetadataStore::getMemoryUsage() const {
+        size_t live = static_cast<size_t>(std::count_if(ids_.begin(), ids_.end(),
+            [](EntityID id) { return id != INVALID_ENTITY; }));
+        size_t perEntity = sizeof(EntityID) + sizeof(std::string) + sizeof(uint32_t) + sizeof(Symbol)
+            + sizeof(EntityFlags) + sizeof(uint32_t) + 2 * sizeof(Link);
+
+        MemoryUsage usage;
+        usage.used = live * perEntity;
+        usage.reserved = vectorMemory(ids_).reserved + vectorMemory(names_).reserved
+            + vectorMemory(nameHashes_).reserved + vectorMemory(typeSymbols_).reserved
+            + vectorMemory(flags_).reserved + vectorMemory(layers_).reserved
+            + vectorMemory(nameLinks_).reserved + vectorMemory(typeLinks_).reserved;
+
+        for (const auto& name : names_) {
+            usage += stringMemory(name);
+        }
+
+        usage += MemoryUsage{ nameCount_ * sizeof(uint32_t), nameTable_.capacity() * sizeof(uint32_t) };
+        usage += vectorMemory(typeHeads_);
+        usage += types_.getMemoryUsage();
+        return usage;
+    }
+
+    void MetadataStore::shrinkToFit() {
+        // Trailing free slots go; prepareSlot() regrows if the indices come back
+        size_t count = ids_.size();
+        while (count > 0 && ids_[count - 1] == INVALID_ENTITY) {
+            --count;
+        }
+
+        auto fit = [count](auto& vector) {
+            vector.resize(count);
+            vector.shrink_to_fit();
+        };
+        fit(ids_);
+        fit(names_);
+        fit(nameHashes_);
+        fit(typeSymbols_);
+        fit(flags_);
+        fit(layers_);
+        fit(nameLinks_);
+        fit(typeLinks_);
+
+        // Smallest power-of-two table that keeps load <= 1/2
+        if (nameCount_ == 0) {
+            nameTable_.clear();
+            nameTable_.shrink_to_fit();
+        }
+        else {
+            size_t size = 64;
+            while (nameCount_ * 2 > size) {
+                size *= 2;
+            }
+            if (size < nameTable_.size()) rehashNameTable(size);
+        }
+
+        while (!typeHeads_.empty() && typeHeads_.back() == NONE) {
+            typeHeads_.pop_back();
+        }
+        typeHeads_.shrink_to_fit();
+
+        types_.shrinkToFit();
+    }
+
+    void MetadataStore::clear() {
+        types_.clear();
+
+        ids_.clear();
+        names_.clear();
+        nameHashes_.clear();
+        typeSymbols_.clear();
+        flags_.clear();
+        layers_.clear();
+        nameLinks_.clear();
+        typeLinks_.clear();
+
+        nameTable_.clear();
+        nameCount_ = 0;
+        typeHeads_.clear();
+    }
+
+    // ========================================================================
+    // NAME INDEX
+    // ========================================================================
+
+    uint32_t MetadataStore::hashName(std::string_view name) {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        for (char c : name) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    size_t MetadataStore::findNameSlot(std::string_view name, uint32_t hash) const {
+        if (nameTable_.empty()) return NONE;
+
+        size_t mask = nameTable_.size() - 1;
+        for (size_t i = hash & mask; nameTable_[i] != EMPTY_SLOT; i = (i + 1) & mask) {
+            uint32_t head = nameTable_[i] - 1;
+            if (nameHashes_[head] == hash && names_[head] == name) return i;
+        }
+        return NONE;
+    }
+
+    void MetadataStore::insertName(uint32_t index) {
+        Link& link = nameLinks_[index];
+        link.prev = link.next = NONE;
+
+        // Join the list of an existing name right after its head
+        size_t slot = findNameSlot(names_[index], nameHashes_[index]);
+        if (slot != NONE) {
+            uint32_t head = nameTable_[slot] - 1;
+            link.prev = head;
+            link.next = nameLinks_[head].next;
+            if (link.next != NONE) nameLinks_[link.next].prev = index;
+            nameLinks_[head].next = index;
+            return;
+        }
+
+        if ((nameCount_ + 1) * 2 > nameTable_.size()) {
+            rehashNameTable(nameTable_.empty() ? 64 : nameTable_.size() * 2);
+        }
+
+        size_t mask = nameTable_.size() - 1;
+        size_t i = nameHashes_[index] & mask;
+        while (nameTable_[i] != EMPTY_SLOT) {
+            i = (i + 1) & mask;
+        }
+        nameTable_[i] = index + 1;
+        ++nameCount_;
+    }
+
+    void MetadataStore::eraseName(uint32_t index) {
+        Link& link = nameLinks_[index];
+
+        if (link.prev != NONE) {
+            // Not the head: plain unlink
+            nameLinks_[link.prev].next = link.next;
+            if (link.next != NONE) nameLinks_[link.next].prev = link.prev;
+            link.prev = link.next = NONE;
+            return;
+        }
+
+        size_t mask = nameTable_.size() - 1;
+        size_t i = nameHashes_[index] & mask;
+        while (nameTable_[i] != index + 1) {
+            i = (i + 1) & mask;
+        }
+
+        if (link.next != NONE) {
+            // Promote the next entity with the same name (same hash, same slot)
+            nameTable_[i] = link.next + 1;
+            nameLinks_[link.next].prev = NONE;
+            link.next = NONE;
+            return;
+        }
+
+        // Backward-shift deletion keeps probe chains intact without tombstones
+        size_t j = i;
+        for (;;) {
+            j = (j + 1) & mask;
+            if (nameTable_[j] == EMPTY_SLOT) break;
+
+            size_t home = nameHashes_[nameTable_[j] - 1] & mask;
+            bool movable = (j > i) ? (home <= i || home > j) : (home <= i && home > j);
+            if (movable) {
+                nameTable_[i] = nameTable_[j];
+                i = j;
+            }
+        }
+
+        nameTable_[i] = EMPTY_SLOT;
+        --nameCount_;
+    }
+
+    void MetadataStore::rehashNameTable(size_t size) {
+        std::vector<uint32_t> old = std::move(nameTable_);
+        nameTable_.assign(size, EMPTY_SLOT);
+
+        size_t mask = nameTable_.size() - 1;
+        for (uint32_t entry : old) {
+            if (entry == EMPTY_SLOT) continue;
+
+            size_t i = nameHashes_[entry - 1] & mask;
+            while (nameTable_[i] != EMPTY_SLOT) {
+                i = (i + 1) & mask;
+            }
+            nameTable_[i] = entry;
+        }
+    }
+
+    // ========================================================================
+    // TYPE BUCKETS
+    // ========================================================================
+
+    void MetadataStore::linkType(uint32_t index) {
+        Symbol symbol = typeSymbols_[index];
+        if (symbol >= typeHeads_.size()) {
+            typeHeads_.resize(static_cast<size_t>(symbol) + 1, NONE);
+        }
+
+        typeLinks_[index].prev = NONE;
+        typeLinks_[index].next = typeHeads_[symbol];
+        if (typeHeads_[symbol] != NONE) {
+            typeLinks_[typeHeads_[symbol]].prev = index;
+        }
+        typeHeads_[symbol] = index;
+    }
+
+    void MetadataStore::unlinkType(uint32_t index) {
+        Link& l = typeLinks_[index];
+        if (l.prev != NONE) typeLinks_[l.prev].next = l.next;
+        else typeHeads_[typeSymbols_[index]] = l.next;
+        if (l.next != NONE) typeLinks_[l.next].prev = l.prev;
+        l.prev = l.next = NONE;
+    }
+
+} // namespace libre
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace libre {
+
+    // ============================================================================
+    // SYMBOL TABLE - Reference-counted string interning
+    // ============================================================================
+    // Each distinct string is stored once. Symbols are small integers that can
+    // index side tables. Symbol 0 is always the empty string. Meant for small,
+    // heavily shared vocabularies such as entity types.
+
+    using Symbol = uint32_t;
+    constexpr Symbol EMPTY_SYMBOL = 0;
+    constexpr Symbol INVALID_SYMBOL = 0xFFFFFFFF;
+
+    class SymbolTable {
+    public:
+        SymbolTable();
+
+        // Intern string and take a reference
+        Symbol intern(std::string_view str);
+
+        // Look up without taking a reference (INVALID_SYMBOL if unknown)
+        Symbol find(std::string_view str) const;
+
+        // Take 'count' more references to a live symbol
+        void retain(Symbol symbol, uint32_t count = 1);
+
+        // Drop a reference; the symbol is recycled when unreferenced
+        void release(Symbol symbol);
+
+        const std::string& str(Symbol symbol) const { return strings_[symbol]; }
+
+        // Number of symbol slots (live + recyclable)
+        size_t capacity() const { return strings_.size(); }
+        size_t size() const { return lookup_.size(); }
+
+        MemoryUsage getMemoryUsage() const;
+        void shrinkToFit();
+
+        void clear();
+
+    private:
+        std::deque<std::string> strings_;      // Stable addresses for lookup_ keys
+        std::vector<uint32_t> refCounts_;
+        std::vector<Symbol> freeList_;
+        std::unordered_map<std::string_view, Symbol> lookup_;
+    };
+
+    // ============================================================================
+    // METADATA STORE - Entity name/type/flags as parallel arrays
+    // ============================================================================
+    // All arrays are indexed by entity index.
+    //
+    // Names are mostly unique, so they are stored per entity (short names stay
+    // in the string's inline buffer). An open-addressing table keyed by name
+    // hash holds one entity index per distinct name; entities sharing a name
+    // ("Cube", "Entity") hang off it in an intrusive list. findByName is O(1)
+    // plus the matches, without a heap node per entity.
+    //
+    // Types are few and shared, so they are interned. Entities of the same type
+    // are linked into an intrusive doubly-linked list per type symbol, so
+    // findByType only walks the matches and unlinking is O(1).
+
+    class MetadataStore {
+    public:
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+        void create(EntityID entity, std::string_view name, std::string_view type);
+
+        // Same name and type for many entities (name hashed and type interned once)
+        void create(const EntityID* entities, size_t count, std::string_view name, std::string_view type);
+        void destroy(EntityID entity);
+        bool contains(EntityID entity) const;
+
+        const std::string& getName(EntityID entity) const;
+        const std::string& getType(EntityID entity) const;
+        void setName(EntityID entity, std::string_view name);
+        void setType(EntityID entity, std::string_view type);
+
+        EntityFlags getFlags(EntityID entity) const;
+        void setFlags(EntityID entity, EntityFlags flags);
+        uint32_t getLayer(EntityID entity) const;
+        void setLayer(EntityID entity, uint32_t layer);
+
+        // Interned type symbol (for cheap equality tests in hot loops)
+        Symbol getTypeSymbol(EntityID entity) const;
+        Symbol findType(std::string_view type) const { return types_.find(type); }
+
+        // Visit entities with exact name / type: func(EntityID)
+        template<typename Func>
+        void forEachWithName(std::string_view name, Func&& func) const {
+            if (nameTable_.empty()) return;
+
+            size_t slot = findNameSlot(name, hashName(name));
+            if (slot == NONE) return;
+            for (uint32_t i = nameTable_[slot] - 1; i != NONE; i = nameLinks_[i].next) {
+                func(ids_[i]);
+            }
+        }
+
+        template<typename Func>
+        void forEachWithType(std::string_view type, Func&& func) const {
+            Symbol symbol = types_.find(type);
+            if (symbol == INVALID_SYMBOL || symbol >= typeHeads_.size()) return;
+            for (uint32_t i = typeHeads_[symbol]; i != NONE; i = typeLinks_[i].next) {
+                func(ids_[i]);
+            }
+        }
+
+        void clear();
+
+        // Per-entity arrays, name strings, name index and interned types
+        MemoryUsage getMemoryUsage() const;
+
+        // Drop unused trailing entity slots and shrink the name index to
+        // fit the names still in use
+        void shrinkToFit();
+
+        size_t getInternedTypeCount() const { return types_.size(); }
+
+    private:
+        static constexpr uint32_t EMPTY_SLOT = 0;   // Table stores index + 1
+
+        struct Link {
+            uint32_t prev = NONE;
+            uint32_t next = NONE;
+        };
+
+        // Index of a live entry, or NONE
+        uint32_t slot(EntityID entity) const;
+
+        // Grow arrays to hold index; clear a stale generation left in it
+        void prepareSlot(uint32_t index);
+
+        static uint32_t hashName(std::string_view name);
+        size_t findNameSlot(std::string_view name, uint32_t hash) const;
+        void insertName(uint32_t index);
+        void eraseName(uint32_t index);
+        void rehashNameTable(size_t size);
+
+        void linkType(uint32_t index);
+        void unlinkType(uint32_t index);
+
+        SymbolTable types_;
+
+        // Per entity index
+        std::vector<EntityID> ids_;            // INVALID_ENTITY when unused
+        std::vector<std::string> names_;
+        std::vector<uint32_t> nameHashes_;
+        std::vector<Symbol> typeSymbols_;
+        std::vector<EntityFlags> flags_;
+        std::vector<uint32_t> layers_;
+        std::vector<Link> nameLinks_;
+        std::vector<Link> typeLinks_;
+
+        // Name index: first entity index + 1 per distinct name. Linear probing,
+        // power-of-two size, load <= 1/2.
+        std::vector<uint32_t> nameTable_;
+        size_t nameCount_ = 0;          // Distinct names
+
+        // Per type symbol: first entity index in the list
+        std::vector<uint32_t> typeHeads_;
+    };
+
+} // namespace libre
@@ -0,0 +1,281 @@
+#include "NodeGraph.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
+namespace libre {
+
+    // ============================================================================
+    // NODES
+    // ============================================================================
+
+    void NodeGraph::addNode(EntityID node, NodeFunc func) {
+        uint32_t slot = slotOf(node);
+        if (slot == NONE) {
+            uint32_t index = getEntityIndex(node);
+            if (index >= slots_.size()) {
+                slots_.resize(static_cast<size_t>(index) + 1, NONE);
+            }
+            slot = static_cast<uint32_t>(entries_.size());
+            slots_[index] = slot;
+            entries_.emplace_back();
+            entries_.back().id = node;
+            topologyDirty_ = true;
+        }
+
+        entries_[slot].func = std::move(func);
+        seeds_.push_back(node);
+    }
+
+    void NodeGraph::removeNode(EntityID node) {
+        uint32_t slot = slotOf(node);
+        if (slot == NONE) return;
+
+        // Consumers notice the missing input when the topology is rebuilt
+        uint32_t last = static_cast<uint32_t>(entries_.size() - 1);
+        if (slot != last) {
+            entries_[slot] = std::move(entries_[last]);
+            slots_[getEntityIndex(entries_[slot].id)] = slot;
+        }
+        entries_.pop_back();
+        slots_[getEntityIndex(node)] = NONE;
+        topologyDirty_ = true;
+    }
+
+    void NodeGraph::markDirty(EntityID node) {
+        if (slotOf(node) != NONE) seeds_.push_back(node);
+    }
+
+    void NodeGraph::markAllDirty() {
+        for (const Entry& entry : entries_) seeds_.push_back(entry.id);
+    }
+
+    void NodeGraph::clear() {
+        entries_.clear();
+        slots_.clear();
+        inputOffsets_.clear();
+        inputSlots_.clear();
+        successorOffsets_.clear();
+        successorSlots_.clear();
+        blocked_.clear();
+        levelCount_ = 0;
+        topologyDirty_ = true;
+        seeds_.clear();
+    }
+
+    // ============================================================================
+    // EVALUATION
+    // ============================================================================
+
+    size_t NodeGraph::evaluate() {
+        if (topologyDirty_ || builtVersion_ != relationships_.getVersion(RelationType::NodeConnection)) {
+            rebuild();
+        }
+        collectDirty();
+        seeds_.clear();
+
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        bool inlineAll = pool_.getWorkerCount() == 0;
+
+        for (uint32_t level = 0; level < levelCount_; ++level) {
+            uint32_t begin = levelOffsets_[level];
+            uint32_t count = levelOffsets_[level + 1] - begin;
+
+            auto runRange = [&](size_t first, size_t end) {
+                for (size_t i = first; i < end; ++i) {
+                    std::exception_ptr failure;
+                    run(byLevel_[begin + i], failure);
+                    if (failure) {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!error) error = failure;
+                    }
+                }
+            };
+
+            // Everything in a level is independent; the next level waits
+            if (count > 1 && !inlineAll) pool_.parallelFor(count, 1, runRange);
+            else runRange(0, count);
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return byLevel_.size();
+    }
+
+    void NodeGraph::run(uint32_t slot, std::exception_ptr& error) {
+        Entry& entry = entries_[slot];
+        uint32_t first = inputOffsets_[slot];
+        NodeContext context(this, entry.id, inputSlots_.data() + first,
+            inputOffsets_[slot + 1] - first, &entry.output);
+
+        entry.output.reset();
+        try {
+            if (entry.func) entry.func(context);
+            entry.state = State::Valid;
+        }
+        catch (...) {
+            entry.output.reset();
+            entry.state = State::Failed;
+            error = std::current_exception();
+        }
+    }
+
+    void NodeGraph::collectDirty() {
+        // Mark the seeds and everything reachable downstream of them
+        work_.clear();
+        auto visit = [&](uint32_t slot) {
+            Entry& entry = entries_[slot];
+            if (entry.level == NONE || entry.state == State::Dirty) return;
+            entry.state = State::Dirty;
+            work_.push_back(slot);
+        };
+
+        for (EntityID id : seeds_) {
+            uint32_t slot = slotOf(id);
+            if (slot != NONE) visit(slot);
+        }
+        for (size_t i = 0; i < work_.size(); ++i) {
+            uint32_t slot = work_[i];
+            for (uint32_t s = successorOffsets_[slot]; s < successorOffsets_[slot + 1]; ++s) {
+                visit(successorSlots_[s]);
+            }
+        }
+
+        // Counting sort by level
+        levelOffsets_.assign(static_cast<size_t>(levelCount_) + 1, 0);
+        for (uint32_t slot : work_) ++levelOffsets_[entries_[slot].level + 1];
+        for (uint32_t level = 0; level < levelCount_; ++level) {
+            levelOffsets_[level + 1] += levelOffsets_[level];
+        }
+
+        byLevel_.resize(work_.size());
+        cursor_.assign(levelOffsets_.begin(), levelOffsets_.end() - 1);
+        for (uint32_t slot : work_) {
+            byLevel_[cursor_[entries_[slot].level]++] = slot;
+        }
+    }
+
+    // ============================================================================
+    // TOPOLOGY
+    // ============================================================================
+
+    void NodeGraph::rebuild() {
+        uint32_t count = static_cast<uint32_t>(entries_.size());
+
+        // Inputs per node, ordered by connection order; only registered producers
+        inputOffsets_.assign(static_cast<size_t>(count) + 1, 0);
+        inputSlots_.clear();
+        std::vector<std::pair<int32_t, uint32_t>> inputs;
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            Entry& entry = entries_[slot];
+
+            inputs.clear();
+            for (const auto& edge : relationships_.getTo(entry.id)) {
+                if (edge.type != RelationType::NodeConnection) continue;
+                uint32_t from = slotOf(edge.from);
+                if (from != NONE) inputs.emplace_back(edge.order, from);
+            }
+            std::stable_sort(inputs.begin(), inputs.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+
+            inputOffsets_[slot] = static_cast<uint32_t>(inputSlots_.size());
+            bool changed = inputs.size() != entry.inputs.size();
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                inputSlots_.push_back(inputs[i].second);
+                EntityID producer = entries_[inputs[i].second].id;
+                if (!changed && entry.inputs[i] != producer) changed = true;
+            }
+
+            // Rewired nodes re-evaluate like edited ones
+            if (changed) {
+                entry.inputs.clear();
+                for (const auto& input : inputs) entry.inputs.push_back(entries_[input.second].id);
+                seeds_.push_back(entry.id);
+            }
+        }
+        inputOffsets_[count] = static_cast<uint32_t>(inputSlots_.size());
+
+        // Successors: the same edges, grouped by producer
+        successorOffsets_.assign(static_cast<size_t>(count) + 1, 0);
+        for (uint32_t input : inputSlots_) ++successorOffsets_[input + 1];
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            successorOffsets_[slot + 1] += successorOffsets_[slot];
+        }
+        successorSlots_.resize(inputSlots_.size());
+        cursor_.assign(successorOffsets_.begin(), successorOffsets_.end() - 1);
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            for (uint32_t i = inputOffsets_[slot]; i < inputOffsets_[slot + 1]; ++i) {
+                successorSlots_[cursor_[inputSlots_[i]]++] = slot;
+            }
+        }
+
+        // Kahn's algorithm; a node's level is one past its deepest input.
+        // Whatever never reaches zero pending inputs is on or below a cycle.
+        std::vector<uint32_t> pending(count);
+        work_.clear();
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            pending[slot] = inputOffsets_[slot + 1] - inputOffsets_[slot];
+            entries_[slot].level = pending[slot] == 0 ? 0 : NONE;
+            if (pending[slot] == 0) work_.push_back(slot);
+        }
+
+        levelCount_ = 0;
+        for (size_t i = 0; i < work_.size(); ++i) {
+            uint32_t slot = work_[i];
+            uint32_t level = entries_[slot].level;
+            levelCount_ = std::max(levelCount_, level + 1);
+
+            for (uint32_t s = successorOffsets_[slot]; s < successorOffsets_[slot + 1]; ++s) {
+                uint32_t next = successorSlots_[s];
+                if (--pending[next] == 0) {
+                    uint32_t deepest = 0;
+                    for (uint32_t in = inputOffsets_[next]; in < inputOffsets_[next + 1]; ++in) {
+                        deepest = std::max(deepest, entries_[inputSlots_[in]].level);
+                    }
+                    entries_[next].level = deepest + 1;
+                    work_.push_back(next);
+                }
+            }
+        }
+
+        blocked_.clear();
+        for (uint32_t slot = 0; slot < count; ++slot) {
+            Entry& entry = entries_[slot];
+            if (entry.level == NONE) {
+                blocked_.push_back(entry.id);
+                entry.output.reset();
+                entry.state = State::Failed;
+            }
+            else if (entry.state != State::Valid) {
+                // Unblocked, new, or failed last time: give it another go
+                seeds_.push_back(entry.id);
+            }
+        }
+
+        builtVersion_ = relationships_.getVersion(RelationType::NodeConnection);
+        topologyDirty_ = false;
+    }
+
+    bool NodeGraph::wouldCreateCycle(EntityID from, EntityID to) const {
+        if (from == to) return true;
+
+        // Does 'to' already feed into 'from'?
+        std::vector<EntityID> stack{ from };
+        std::unordered_set<EntityID> seen{ from };
+        while (!stack.empty()) {
+            EntityID node = stack.back();
+            stack.pop_back();
+
+            for (const auto& edge : relationships_.getTo(node)) {
+                if (edge.type != RelationType::NodeConnection) continue;
+                if (edge.from == to) return true;
+                if (seen.insert(edge.from).second) stack.push_back(edge.from);
+            }
+        }
+        return false;
+    }
+
+} // namespace libre
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "Types.h"
+#include "RelationshipStore.h"
+#include "../core/ThreadPool.h"
+#include <vector>
+#include <any>
+#include <functional>
+#include <exception>
+
+namespace libre {
+
+    class NodeGraph;
+
+    // ============================================================================
+    // NODE CONTEXT - What a node sees while it evaluates
+    // ============================================================================
+    // Inputs are the outputs of the nodes connected to this one, ordered by
+    // the connection's order field. An input is null if that node failed,
+    // sits on a cycle, or produced a value of another type.
+
+    class NodeContext {
+    public:
+        EntityID getNode() const { return node_; }
+        size_t getInputCount() const { return inputCount_; }
+
+        // Null if the input is missing or holds something other than T
+        template<typename T>
+        const T* input(size_t slot) const {
+            const std::any* value = inputValue(slot);
+            return value ? std::any_cast<T>(value) : nullptr;
+        }
+
+        template<typename T>
+        void setOutput(T value) { *output_ = std::move(value); }
+
+    private:
+        friend class NodeGraph;
+
+        NodeContext(const NodeGraph* graph, EntityID node, const uint32_t* inputs, size_t inputCount, std::any* output)
+            : graph_(graph), node_(node), inputs_(inputs), inputCount_(inputCount), output_(output) {
+        }
+
+        const std::any* inputValue(size_t slot) const;
+
+        const NodeGraph* graph_;
+        EntityID node_;
+        const uint32_t* inputs_;
+        size_t inputCount_;
+        std::any* output_;
+    };
+
+    // ============================================================================
+    // NODE GRAPH - Incremental evaluation of NodeConnection graphs
+    // ============================================================================
+    // Nodes are entities registered with an evaluation function; connections
+    // are NodeConnection relationships (from = producer, to = consumer) in
+    // the world's RelationshipStore. Every node caches its last output.
+    //
+    // markDirty() flags a node whose parameters changed. evaluate() first
+    // rebuilds the topology if the NodeConnection edges or the node set
+    // changed (a node whose input list changed counts as dirty), then
+    // re-evaluates the dirty nodes and everything downstream of them, and
+    // nothing else. Nodes are grouped into levels by longest path from a
+    // source; a level only reads the levels before it, so its dirty nodes
+    // run in parallel on the thread pool.
+    //
+    // Nodes on a cycle, or downstream of one, can't be ordered: they are
+    // skipped, their outputs cleared, and getBlockedNodes() lists them until
+    // the cycle is broken. wouldCreateCycle() lets an editor refuse such a
+    // connection up front.
+    //
+    // Node functions run concurrently and must only touch their own context.
+    // Destroyed entities must be removed with removeNode().
+    //
+    //     NodeGraph graph(world.getRelationships());
+    //     graph.addNode(noise, [](NodeContext& ctx) { ctx.setOutput(makeNoise()); });
+    //     graph.addNode(blur, [](NodeContext& ctx) {
+    //         if (auto* in = ctx.input<Image>(0)) ctx.setOutput(blurImage(*in));
+    //     });
+    //     world.addRelationship({ RelationType::NodeConnection, noise, blur });
+    //     graph.evaluate();
+
+    class NodeGraph {
+    public:
+        using NodeFunc = std::function<void(NodeContext& context)>;
+
+        explicit NodeGraph(const RelationshipStore& relationships, ThreadPool& pool = ThreadPool::instance())
+            : relationships_(relationships), pool_(pool) {
+        }
+
+        // ========================================================================
+        // NODES
+        // ========================================================================
+
+        // Register (or replace the function of) a node. It runs at the next
+        // evaluate().
+        void addNode(EntityID node, NodeFunc func);
+        void removeNode(EntityID node);
+        bool hasNode(EntityID node) const { return slotOf(node) != NONE; }
+        size_t getNodeCount() const { return entries_.size(); }
+
+        // Re-evaluate 'node' and everything downstream at the next evaluate()
+        void markDirty(EntityID node);
+        void markAllDirty();
+
+        // Cached output; null if the node has none (yet) or holds another type
+        template<typename T>
+        const T* getOutput(EntityID node) const {
+            uint32_t slot = slotOf(node);
+            if (slot == NONE || entries_[slot].state != State::Valid) return nullptr;
+            return std::any_cast<T>(&entries_[slot].output);
+        }
+
+        // ========================================================================
+        // EVALUATION
+        // ========================================================================
+
+        // Bring every output up to date. Returns the number of nodes that
+        // ran. The first exception thrown by a node function is rethrown
+        // after the rest of the graph is done; the failed node's output is
+        // cleared.
+        size_t evaluate();
+
+        // Nodes on or downstream of a cycle, as of the last evaluate()
+        const std::vector<EntityID>& getBlockedNodes() const { return blocked_; }
+
+        // True if connecting from -> to would close a cycle of
+        // NodeConnection edges. O(nodes upstream of 'from').
+        bool wouldCreateCycle(EntityID from, EntityID to) const;
+
+        // Longest path from a source (0 for sources); 0 if unknown or blocked
+        uint32_t getLevel(EntityID node) const {
+            uint32_t slot = slotOf(node);
+            return slot != NONE && entries_[slot].level != NONE ? entries_[slot].level : 0;
+        }
+
+        void clear();
+
+    private:
+        friend class NodeContext;
+
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+        enum class State : uint8_t {
+            Failed,         // Not run yet, threw, or blocked; output empty
+            Valid,          // Output is current
+            Dirty,          // Queued by the evaluate() in progress
+        };
+
+        struct Entry {
+            EntityID id = INVALID_ENTITY;
+            NodeFunc func;
+            std::any output;
+            std::vector<EntityID> inputs;   // Producers by slot, as last built
+            uint32_t level = NONE;          // NONE: on or below a cycle
+            State state = State::Failed;
+        };
+
+        uint32_t slotOf(EntityID node) const {
+            uint32_t index = getEntityIndex(node);
+            if (index >= slots_.size() || slots_[index] == NONE) return NONE;
+            return entries_[slots_[index]].id == node ? slots_[index] : NONE;
+        }
+
+        // Inputs, successors and levels from the current NodeConnection edges
+        void rebuild();
+
+        // Dirty seeds plus everything downstream, bucketed by level
+        void collectDirty();
+
+        void run(uint32_t slot, std::exception_ptr& error);
+
+        const RelationshipStore& relationships_;
+        ThreadPool& pool_;
+
+        std::vector<Entry> entries_;        // Dense; swap-removed
+        std::vector<uint32_t> slots_;       // Entity index -> entry (NONE if absent)
+
+        // Topology (valid while !topologyDirty_), CSR by entry
+        std::vector<uint32_t> inputOffsets_;
+        std::vector<uint32_t> inputSlots_;
+        std::vector<uint32_t> successorOffsets_;
+        std::vector<uint32_t> successorSlots_;
+        std::vector<EntityID> blocked_;
+        uint32_t levelCount_ = 0;
+        uint64_t builtVersion_ = 0;
+        bool topologyDirty_ = true;
+
+        // Evaluation scratch, reused between calls
+        std::vector<EntityID> seeds_;       // Marked dirty since the last evaluate()
+        std::vector<uint32_t> work_;
+        std::vector<uint32_t> levelOffsets_;
+        std::vector<uint32_t> byLevel_;
+        std::vector<uint32_t> cursor_;
+    };
+
+    inline const std::any* NodeContext::inputValue(size_t slot) const {
+        if (slot >= inputCount_) return nullptr;
+        const auto& entry = graph_->entries_[inputs_[slot]];
+        return entry.state == NodeGraph::State::Valid ? &entry.output : nullptr;
+    }
+
+} // namespace libre
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <utility>
+
+namespace libre {
+
+    // ============================================================================
+    // COMPONENT OBSERVERS - Batched add/remove notifications per component type
+    // ============================================================================
+    // World records the entities that gained or lost an observed component
+    // into one contiguous buffer per type; types nobody observes aren't
+    // recorded at all. dispatch() runs at a sync point: each buffer is sorted
+    // by entity and reduced to the net change since the last dispatch (an
+    // entity added and removed again shows up in neither batch, a
+    // remove-and-re-add reads as an add), then every handler is called once
+    // with the whole batch. Removal batches go out before addition batches.
+    //
+    // Handlers may add or remove components and entities; those changes are
+    // recorded for the next dispatch. Recording isn't thread-safe, same as
+    // the structural changes that trigger it.
+    //
+    //     world.onAdd<MeshComponent>([&](const std::vector<EntityID>& added) { ... });
+    //     world.dispatchObservers();   // Once per frame, no system running
+
+    using ObserverID = uint32_t;
+    constexpr ObserverID INVALID_OBSERVER = 0;
+
+    enum class ObserverEvent : uint8_t {
+        Remove = 0,     // Dispatched first
+        Add = 1
+    };
+
+    class ComponentObservers {
+    public:
+        using Handler = std::function<void(const std::vector<EntityID>& entities)>;
+
+        ObserverID add(ComponentTypeID type, ObserverEvent event, Handler handler) {
+            ObserverID id = nextId_++;
+            Entry entry{ id, type, event, std::move(handler) };
+
+            // The handler list may be mid-iteration; append after the dispatch
+            if (dispatching_) {
+                deferred_.push_back(std::move(entry));
+            }
+            else {
+                attach(std::move(entry));
+            }
+            return id;
+        }
+
+        void remove(ObserverID id) {
+            for (auto& slot : slots_) {
+                for (auto& handlers : slot.handlers) {
+                    for (auto& entry : handlers) {
+                        // Blanked now, erased once no dispatch is running
+                        if (entry.id == id) {
+                            entry.id = INVALID_OBSERVER;
+                            entry.handler = nullptr;
+                            pruneNeeded_ = true;
+                        }
+                    }
+                }
+            }
+            deferred_.erase(std::remove_if(deferred_.begin(), deferred_.end(),
+                [id](const Entry& entry) { return entry.id == id; }), deferred_.end());
+
+            if (!dispatching_) prune();
+        }
+
+        // Cheap test for the hot paths: is anyone listening to this type?
+        // Both events are recorded if so, so a batch can tell whether an
+        // entity had the component before.
+        bool wants(ComponentTypeID type) const {
+            if (type >= slots_.size()) return false;
+            const Slot& slot = slots_[type];
+            return !slot.handlers[0].empty() || !slot.handlers[1].empty();
+        }
+
+        void record(ComponentTypeID type, ObserverEvent event, EntityID entity) {
+            auto& pending = slots_[type].pending;
+            pending.push_back({ entity, static_cast<uint32_t>(pending.size()), event });
+        }
+
+        void record(ComponentTypeID type, ObserverEvent event, const EntityID* entities, size_t count) {
+            for (size_t i = 0; i < count; ++i) record(type, event, entities[i]);
+        }
+
+        // Record removals for every observed type the entities currently
+        // have (call before they lose them). has(EntityID, ComponentTypeID).
+        template<typename HasFunc>
+        void recordRemovals(const EntityID* entities, size_t count, HasFunc&& has) {
+            for (ComponentTypeID type = 0; type < slots_.size(); ++type) {
+                if (!wants(type)) continue;
+                for (size_t i = 0; i < count; ++i) {
+                    if (has(entities[i], type)) record(type, ObserverEvent::Remove, entities[i]);
+                }
+            }
+        }
+
+        // Deliver everything recorded so far. has(EntityID, ComponentTypeID)
+        // reports the current state. Returns the number of batches delivered.
+        template<typename HasFunc>
+        size_t dispatch(HasFunc&& has) {
+            dispatching_ = true;
+            size_t batches = 0;
+
+            for (ComponentTypeID type = 0; type < slots_.size(); ++type) {
+                if (slots_[type].pending.empty()) continue;
+
+                // Handlers record into the (now empty) pending buffer
+                records_.swap(slots_[type].pending);
+                classify(type, has);
+
+                for (ObserverEvent event : { ObserverEvent::Remove, ObserverEvent::Add }) {
+                    const auto& batch = batches_[index(event)];
+                    const auto& handlers = slots_[type].handlers[index(event)];
+                    if (batch.empty() || handlers.empty()) continue;
+
+                    for (const auto& entry : handlers) {
+                        if (entry.handler) entry.handler(batch);
+                    }
+                    ++batches;
+                }
+                records_.clear();
+            }
+
+            dispatching_ = false;
+            for (auto& entry : deferred_) attach(std::move(entry));
+            deferred_.clear();
+            prune();
+            return batches;
+        }
+
+        // Forget recorded entities without dispatching them
+        void discardPending() {
+            for (auto& slot : slots_) slot.pending.clear();
+        }
+
+        size_t getObserverCount() const {
+            size_t count = deferred_.size();
+            for (const auto& slot : slots_) {
+                for (const auto& handlers : slot.handlers) {
+                    count += std::count_if(handlers.begin(), handlers.end(),
+                        [](const Entry& entry) { return entry.id != INVALID_OBSERVER; });
+                }
+            }
+            return count;
+        }
+
+    private:
+        struct Entry {
+            ObserverID id = INVALID_OBSERVER;
+            ComponentTypeID type = 0;
+            ObserverEvent event = ObserverEvent::Add;
+            Handler handler;
+        };
+
+        struct Record {
+            EntityID entity = INVALID_ENTITY;
+            uint32_t order = 0;         // Position in the pending buffer
+            ObserverEvent event = ObserverEvent::Add;
+        };
+
+        struct Slot {
+            std::vector<Entry> handlers[2];     // Indexed by ObserverEvent
+            std::vector<Record> pending;        // In recording order
+        };
+
+        static size_t index(ObserverEvent event) { return static_cast<size_t>(event); }
+
+        void attach(Entry entry) {
+            if (entry.type >= slots_.size()) {
+                slots_.resize(static_cast<size_t>(entry.type) + 1);
+            }
+            slots_[entry.type].handlers[index(entry.event)].push_back(std::move(entry));
+        }
+
+        // Net effect per entity: the first record says whether it had the
+        // component before (a removal means it did), has() says whether it
+        // has it now. Lost -> removed; gained or replaced -> added.
+        template<typename HasFunc>
+        void classify(ComponentTypeID type, HasFunc& has) {
+            std::sort(records_.begin(), records_.end(), [](const Record& a, const Record& b) {
+                return a.entity != b.entity ? a.entity < b.entity : a.order < b.order;
+                });
+
+            auto& removed = batches_[index(ObserverEvent::Remove)];
+            auto& added = batches_[index(ObserverEvent::Add)];
+            removed.clear();
+            added.clear();
+
+            for (size_t i = 0; i < records_.size(); ) {
+                EntityID entity = records_[i].entity;
+                bool hadBefore = records_[i].event == ObserverEvent::Remove;
+                while (i < records_.size() && records_[i].entity == entity) ++i;
+
+                if (has(entity, type)) added.push_back(entity);
+                else if (hadBefore) removed.push_back(entity);
+            }
+        }
+
+        void prune() {
+            if (!pruneNeeded_) return;
+            for (auto& slot : slots_) {
+                for (size_t e = 0; e < 2; ++e) {
+                    auto& handlers = slot.handlers[e];
+                    handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+                        [](const Entry& entry) { return entry.id == INVALID_OBSERVER; }), handlers.end());
+                }
+                // Nobody left to tell
+                if (slot.handlers[0].empty() && slot.handlers[1].empty()) slot.pending.clear();
+            }
+            pruneNeeded_ = false;
+        }
+
+        std::vector<Slot> slots_;           // By ComponentTypeID
+        std::vector<Entry> deferred_;       // Added during dispatch()
+        std::vector<Record> records_;       // Reused dispatch buffers
+        std::vector<EntityID> batches_[2];
+        ObserverID nextId_ = 1;
+        bool dispatching_ = false;
+        bool pruneNeeded_ = false;
+    };
+
+} // namespace libre
@@ -20,7 +20,7 @@ namespace libre {
 
             MeshComponent mesh;
             generateCubeMesh(mesh, size);
-            world.addComponent<MeshComponent>(id, mesh);
+            world.addComponent<MeshComponent>(id, std::move(mesh));
 
             RenderComponent render;
             render.baseColor = glm::vec3(0.8f, 0.8f, 0.8f);
@@ -43,7 +43,7 @@ namespace libre {
 
             MeshComponent mesh;
             generateSphereMesh(mesh, radius, segments, rings);
-            world.addComponent<MeshComponent>(id, mesh);
+            world.addComponent<MeshComponent>(id, std::move(mesh));
 
             RenderComponent render;
             render.baseColor = glm::vec3(0.8f, 0.8f, 0.8f);
@@ -65,7 +65,7 @@ namespace libre {
 
             MeshComponent mesh;
             generateCylinderMesh(mesh, radius, height, segments);
-            world.addComponent<MeshComponent>(id, mesh);
+            world.addComponent<MeshComponent>(id, std::move(mesh));
 
             RenderComponent render;
             render.baseColor = glm::vec3(0.8f, 0.8f, 0.8f);
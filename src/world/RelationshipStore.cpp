@@ -0,0 +1,251 @@
+#include "RelationshipStore.h"
+#include <algorithm>
+
+namespace libre {
+
+    // ============================================================================
+    // ADD/REMOVE
+    // ============================================================================
+
+    EdgeID RelationshipStore::add(const Relationship& rel) {
+        EdgeID id = find(rel.from, rel.to, rel.type);
+        if (id == INVALID_EDGE) {
+            id = allocateEdge();
+
+            Edge& edge = edges_[id];
+            edge = Edge{};
+            edge.from = rel.from;
+            edge.to = rel.to;
+            edge.type = rel.type;
+
+            // Append to the source's outgoing list
+            Node& from = touchNode(rel.from);
+            edge.prevOut = from.lastOut;
+            if (from.lastOut != INVALID_EDGE) edges_[from.lastOut].nextOut = id;
+            else from.firstOut = id;
+            from.lastOut = id;
+            ++from.outCount;
+
+            // ... the target's incoming list
+            Node& to = touchNode(rel.to);
+            edge.prevIn = to.lastIn;
+            if (to.lastIn != INVALID_EDGE) edges_[to.lastIn].nextIn = id;
+            else to.firstIn = id;
+            to.lastIn = id;
+            ++to.inCount;
+
+            // ... and the type list
+            TypeList& list = types_[static_cast<size_t>(rel.type)];
+            edge.prevOfType = list.last;
+            if (list.last != INVALID_EDGE) edges_[list.last].nextOfType = id;
+            else list.first = id;
+            list.last = id;
+            ++list.count;
+            ++list.version;
+
+            ++edgeCount_;
+        }
+        else if (edges_[id].order != rel.order) {
+            ++types_[static_cast<size_t>(rel.type)].version;
+        }
+
+        edges_[id].order = rel.order;
+        weights_[id] = rel.weight;
+        setLabel(id, rel.label);
+        return id;
+    }
+
+    void RelationshipStore::remove(EdgeID id) {
+        assert(isValid(id));
+        Edge& edge = edges_[id];
+
+        Node& from = nodes_[getEntityIndex(edge.from)];
+        if (edge.prevOut != INVALID_EDGE) edges_[edge.prevOut].nextOut = edge.nextOut;
+        else from.firstOut = edge.nextOut;
+        if (edge.nextOut != INVALID_EDGE) edges_[edge.nextOut].prevOut = edge.prevOut;
+        else from.lastOut = edge.prevOut;
+        --from.outCount;
+
+        Node& to = nodes_[getEntityIndex(edge.to)];
+        if (edge.prevIn != INVALID_EDGE) edges_[edge.prevIn].nextIn = edge.nextIn;
+        else to.firstIn = edge.nextIn;
+        if (edge.nextIn != INVALID_EDGE) edges_[edge.nextIn].prevIn = edge.prevIn;
+        else to.lastIn = edge.prevIn;
+        --to.inCount;
+
+        TypeList& list = types_[static_cast<size_t>(edge.type)];
+        if (edge.prevOfType != INVALID_EDGE) edges_[edge.prevOfType].nextOfType = edge.nextOfType;
+        else list.first = edge.nextOfType;
+        if (edge.nextOfType != INVALID_EDGE) edges_[edge.nextOfType].prevOfType = edge.prevOfType;
+        else list.last = edge.prevOfType;
+        --list.count;
+        ++list.version;
+
+        if (!labels_.empty()) labels_.erase(id);
+
+        // Slot goes on the free list
+        edge = Edge{};
+        edge.nextOut = freeHead_;
+        freeHead_ = id;
+        --edgeCount_;
+    }
+
+    void RelationshipStore::removeEntity(EntityID entity) {
+        const Node* n = node(entity);
+        if (!n) return;
+
+        // remove() keeps the list heads current, so pop from the front
+        while (n->firstOut != INVALID_EDGE) remove(n->firstOut);
+        while (n->firstIn != INVALID_EDGE) remove(n->firstIn);
+    }
+
+    void RelationshipStore::clear() {
+        edges_.clear();
+        weights_.clear();
+        labels_.clear();
+        nodes_.clear();
+
+        // Versions keep counting so nobody mistakes the empty store for
+        // the one they last saw
+        for (TypeList& list : types_) {
+            uint64_t version = list.version + 1;
+            list = TypeList{};
+            list.version = version;
+        }
+        freeHead_ = INVALID_EDGE;
+        edgeCount_ = 0;
+    }
+
+    // ============================================================================
+    // EDGES
+    // ============================================================================
+
+    Relationship RelationshipStore::get(EdgeID id) const {
+        const Edge& edge = edges_[id];
+
+        Relationship rel;
+        rel.type = edge.type;
+        rel.from = edge.from;
+        rel.to = edge.to;
+        rel.order = edge.order;
+        rel.label = getLabel(id);
+        rel.weight = weights_[id];
+        return rel;
+    }
+
+    EdgeID RelationshipStore::find(EntityID from, EntityID to, RelationType type) const {
+        const Node* source = node(from);
+        const Node* target = node(to);
+        if (!source || !target) return INVALID_EDGE;
+
+        if (source->outCount <= target->inCount) {
+            for (EdgeID id = source->firstOut; id != INVALID_EDGE; id = edges_[id].nextOut) {
+                if (edges_[id].to == to && edges_[id].type == type) return id;
+            }
+        }
+        else {
+            for (EdgeID id = target->firstIn; id != INVALID_EDGE; id = edges_[id].nextIn) {
+                if (edges_[id].from == from && edges_[id].type == type) return id;
+            }
+        }
+        return INVALID_EDGE;
+    }
+
+    const std::string& RelationshipStore::getLabel(EdgeID id) const {
+        static const std::string empty;
+        auto it = labels_.find(id);
+        return it != labels_.end() ? it->second : empty;
+    }
+
+    void RelationshipStore::setLabel(EdgeID id, const std::string& label) {
+        if (label.empty()) {
+            if (!labels_.empty()) labels_.erase(id);
+            return;
+        }
+        labels_[id] = label;
+    }
+
+    // ============================================================================
+    // MEMORY
+    // ============================================================================
+
+    MemoryUsage RelationshipStore::getMemoryUsage() const {
+        // Free slots are allocated but hold nothing
+        size_t freeSlots = edges_.size() - edgeCount_;
+
+        MemoryUsage usage = vectorMemory(edges_);
+        usage.used -= freeSlots * sizeof(Edge);
+        MemoryUsage weights = vectorMemory(weights_);
+        weights.used -= freeSlots * sizeof(float);
+        usage += weights;
+
+        usage += vectorMemory(nodes_);
+        usage += hashMemory(labels_);
+        for (const auto& [id, label] : labels_) {
+            usage += stringMemory(label);
+        }
+        return usage;
+    }
+
+    void RelationshipStore::shrinkToFit() {
+        size_t count = edges_.size();
+        while (count > 0 && edges_[count - 1].from == INVALID_ENTITY) {
+            --count;
+        }
+
+        if (count < edges_.size()) {
+            edges_.resize(count);
+            weights_.resize(count);
+
+            // Rebuild the free list from the interior holes
+            freeHead_ = INVALID_EDGE;
+            for (size_t i = count; i-- > 0; ) {
+                if (edges_[i].from != INVALID_ENTITY) continue;
+                edges_[i].nextOut = freeHead_;
+                freeHead_ = static_cast<EdgeID>(i);
+            }
+        }
+        edges_.shrink_to_fit();
+        weights_.shrink_to_fit();
+
+        while (!nodes_.empty() && nodes_.back().empty()) {
+            nodes_.pop_back();
+        }
+        nodes_.shrink_to_fit();
+
+        labels_.rehash(0);
+    }
+
+    // ============================================================================
+    // INTERNALS
+    // ============================================================================
+
+    RelationshipStore::Node& RelationshipStore::touchNode(EntityID entity) {
+        uint32_t index = getEntityIndex(entity);
+        if (index >= nodes_.size()) {
+            nodes_.resize(static_cast<size_t>(index) + 1);
+        }
+
+        Node& n = nodes_[index];
+        if (n.id != entity) {
+            // A previous generation may only hand over an empty slot
+            assert(n.empty() && "stale entity still has relationships");
+            n = Node{};
+            n.id = entity;
+        }
+        return n;
+    }
+
+    EdgeID RelationshipStore::allocateEdge() {
+        if (freeHead_ != INVALID_EDGE) {
+            EdgeID id = freeHead_;
+            freeHead_ = edges_[id].nextOut;
+            return id;
+        }
+
+        edges_.emplace_back();
+        weights_.push_back(1.0f);
+        return static_cast<EdgeID>(edges_.size() - 1);
+    }
+
+} // namespace libre
@@ -2,16 +2,20 @@
 
 #include "Types.h"
 #include <vector>
+#include <array>
+#include <string>
 #include <unordered_map>
-#include <unordered_set>
-#include <algorithm>
-#include <functional>
+#include <iterator>
+#include <cassert>
 
 namespace libre {
 
     // ============================================================================
     // RELATIONSHIP - Connection between two entities
     // ============================================================================
+    // Value type for add() and get(). The store itself keeps only the
+    // endpoints, type and order per edge; label and weight live in side
+    // tables.
 
     struct Relationship {
         RelationType type;
@@ -28,244 +32,247 @@ namespace libre {
         }
     };
 
-    // Hash for Relationship
-    struct RelationshipHash {
-        size_t operator()(const Relationship& r) const {
-            size_t h1 = std::hash<uint8_t>{}(static_cast<uint8_t>(r.type));
-            size_t h2 = std::hash<EntityID>{}(r.from);
-            size_t h3 = std::hash<EntityID>{}(r.to);
-            return h1 ^ (h2 << 1) ^ (h3 << 2);
-        }
-    };
+    // Index into the edge table. Valid until the edge is removed; removed
+    // IDs are reused by later add()s.
+    using EdgeID = uint32_t;
+    constexpr EdgeID INVALID_EDGE = 0xFFFFFFFF;
 
     // ============================================================================
-    // RELATIONSHIP STORE
+    // RELATIONSHIP STORE - Compact edge table with intrusive adjacency lists
     // ============================================================================
+    // One 48-byte Edge per relationship. Every edge sits on three doubly
+    // linked lists threaded through the table: its source's outgoing list,
+    // its target's incoming list and its type's list, each in insertion
+    // order. Per-entity list heads live in a flat array indexed by entity
+    // index, so adding or unlinking an edge is O(1) and removing an entity
+    // is O(degree). Weights are a parallel array; labels are a sparse map
+    // since few edges have one.
+    //
+    // An entity index can carry edges for one generation at a time; World
+    // removes a destroyed entity's edges before the index is recycled.
+    // World keeps the scene hierarchy in HierarchyStore, not here.
+    // Don't add or remove edges while iterating an EdgeRange.
 
     class RelationshipStore {
     public:
-        // ========================================================================
-        // ADD/REMOVE RELATIONSHIPS
-        // ========================================================================
+        static constexpr size_t TYPE_COUNT = RELATION_TYPE_COUNT;
+
+        struct Edge {
+            EntityID from = INVALID_ENTITY;     // INVALID_ENTITY: free slot
+            EntityID to = INVALID_ENTITY;
+
+            // Intrusive list links (INVALID_EDGE terminates)
+            EdgeID nextOut = INVALID_EDGE;      // Same 'from'; free list link
+            EdgeID prevOut = INVALID_EDGE;
+            EdgeID nextIn = INVALID_EDGE;       // Same 'to'
+            EdgeID prevIn = INVALID_EDGE;
+            EdgeID nextOfType = INVALID_EDGE;
+            EdgeID prevOfType = INVALID_EDGE;
+
+            int32_t order = 0;
+            RelationType type = RelationType::ParentChild;
+        };
+
+        enum class EdgeList : uint8_t { Out, In, Type };
+
+        // Walks one adjacency list; yields const Edge&, it.id() is the EdgeID
+        class EdgeRange {
+        public:
+            class iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = Edge;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const Edge*;
+                using reference = const Edge&;
+
+                iterator(const Edge* edges, EdgeID current, EdgeList list)
+                    : edges_(edges), current_(current), list_(list) {
+                }
 
-        // Add a relationship
-        void add(const Relationship& rel) {
-            relationships_.insert(rel);
+                const Edge& operator*() const { return edges_[current_]; }
+                const Edge* operator->() const { return &edges_[current_]; }
+                EdgeID id() const { return current_; }
 
-            // Index by 'from' entity
-            fromIndex_[rel.from].push_back(rel);
+                iterator& operator++() {
+                    const Edge& edge = edges_[current_];
+                    current_ = list_ == EdgeList::Out ? edge.nextOut
+                        : list_ == EdgeList::In ? edge.nextIn : edge.nextOfType;
+                    return *this;
+                }
 
-            // Index by 'to' entity
-            toIndex_[rel.to].push_back(rel);
+                iterator operator++(int) {
+                    iterator old = *this;
+                    ++*this;
+                    return old;
+                }
 
-            // Index by type
-            typeIndex_[rel.type].push_back(rel);
-        }
+                bool operator==(const iterator& other) const { return current_ == other.current_; }
+                bool operator!=(const iterator& other) const { return current_ != other.current_; }
+
+            private:
+                const Edge* edges_;
+                EdgeID current_;
+                EdgeList list_;
+            };
 
-        // Add parent-child relationship (convenience)
-        void setParent(EntityID child, EntityID parent) {
-            // Remove existing parent relationship
-            removeParent(child);
-
-            if (parent != INVALID_ENTITY) {
-                Relationship rel;
-                rel.type = RelationType::ParentChild;
-                rel.from = parent;
-                rel.to = child;
-                add(rel);
+            EdgeRange(const Edge* edges, EdgeID first, uint32_t count, EdgeList list)
+                : edges_(edges), first_(first), count_(count), list_(list) {
             }
-        }
+
+            iterator begin() const { return iterator(edges_, first_, list_); }
+            iterator end() const { return iterator(edges_, INVALID_EDGE, list_); }
+            size_t size() const { return count_; }
+            bool empty() const { return count_ == 0; }
+
+        private:
+            const Edge* edges_;
+            EdgeID first_;
+            uint32_t count_;
+            EdgeList list_;
+        };
+
+        // ========================================================================
+        // ADD/REMOVE RELATIONSHIPS
+        // ========================================================================
+
+        // Add a relationship. An existing (from, to, type) edge is updated
+        // in place instead of duplicated.
+        EdgeID add(const Relationship& rel);
 
         // Remove a relationship
         void remove(const Relationship& rel) {
-            relationships_.erase(rel);
-
-            // Remove from indices
-            removeFromVector(fromIndex_[rel.from], rel);
-            removeFromVector(toIndex_[rel.to], rel);
-            removeFromVector(typeIndex_[rel.type], rel);
+            EdgeID edge = find(rel.from, rel.to, rel.type);
+            if (edge != INVALID_EDGE) remove(edge);
         }
 
-        // Remove parent relationship
-        void removeParent(EntityID child) {
-            auto it = toIndex_.find(child);
-            if (it != toIndex_.end()) {
-                auto& rels = it->second;
-                for (auto rit = rels.begin(); rit != rels.end(); ) {
-                    if (rit->type == RelationType::ParentChild) {
-                        Relationship rel = *rit;
-                        relationships_.erase(rel);
-                        removeFromVector(fromIndex_[rel.from], rel);
-                        removeFromVector(typeIndex_[rel.type], rel);
-                        rit = rels.erase(rit);
-                    }
-                    else {
-                        ++rit;
-                    }
-                }
-            }
-        }
+        // O(1)
+        void remove(EdgeID edge);
 
         // Remove all relationships involving an entity
-        void removeEntity(EntityID entity) {
-            // Remove where entity is 'from'
-            if (auto it = fromIndex_.find(entity); it != fromIndex_.end()) {
-                for (const auto& rel : it->second) {
-                    relationships_.erase(rel);
-                    removeFromVector(toIndex_[rel.to], rel);
-                    removeFromVector(typeIndex_[rel.type], rel);
-                }
-                fromIndex_.erase(it);
-            }
+        void removeEntity(EntityID entity);
 
-            // Remove where entity is 'to'
-            if (auto it = toIndex_.find(entity); it != toIndex_.end()) {
-                for (const auto& rel : it->second) {
-                    relationships_.erase(rel);
-                    removeFromVector(fromIndex_[rel.from], rel);
-                    removeFromVector(typeIndex_[rel.type], rel);
-                }
-                toIndex_.erase(it);
-            }
+        // Remove all relationships involving any of 'entities'. O(total
+        // degree); edges between two doomed entities are unlinked once.
+        void removeEntities(const std::vector<EntityID>& entities) {
+            for (EntityID entity : entities) removeEntity(entity);
         }
 
         // ========================================================================
-        // QUERIES
+        // EDGES
         // ========================================================================
 
-        // Get parent of entity
-        EntityID getParent(EntityID child) const {
-            auto it = toIndex_.find(child);
-            if (it != toIndex_.end()) {
-                for (const auto& rel : it->second) {
-                    if (rel.type == RelationType::ParentChild) {
-                        return rel.from;
-                    }
-                }
-            }
-            return INVALID_ENTITY;
+        bool isValid(EdgeID edge) const {
+            return edge < edges_.size() && edges_[edge].from != INVALID_ENTITY;
         }
 
-        // Get children of entity
-        std::vector<EntityID> getChildren(EntityID parent) const {
-            std::vector<EntityID> children;
-            auto it = fromIndex_.find(parent);
-            if (it != fromIndex_.end()) {
-                for (const auto& rel : it->second) {
-                    if (rel.type == RelationType::ParentChild) {
-                        children.push_back(rel.to);
-                    }
-                }
-            }
-            return children;
-        }
+        const Edge& getEdge(EdgeID edge) const { return edges_[edge]; }
 
-        // Get all root entities (no parent)
-        std::vector<EntityID> getRoots(const std::unordered_set<EntityID>& allEntities) const {
-            std::vector<EntityID> roots;
-            for (EntityID id : allEntities) {
-                if (getParent(id) == INVALID_ENTITY) {
-                    roots.push_back(id);
-                }
-            }
-            return roots;
-        }
+        // Full copy including label and weight
+        Relationship get(EdgeID edge) const;
+
+        // INVALID_EDGE if absent. Walks the shorter of the two endpoint lists.
+        EdgeID find(EntityID from, EntityID to, RelationType type) const;
 
-        // Get relationships from entity
-        const std::vector<Relationship>& getFrom(EntityID entity) const {
-            static std::vector<Relationship> empty;
-            auto it = fromIndex_.find(entity);
-            return (it != fromIndex_.end()) ? it->second : empty;
+        float getWeight(EdgeID edge) const { return weights_[edge]; }
+        void setWeight(EdgeID edge, float weight) { weights_[edge] = weight; }
+
+        // Empty string if the edge has no label
+        const std::string& getLabel(EdgeID edge) const;
+        void setLabel(EdgeID edge, const std::string& label);
+
+        // ========================================================================
+        // QUERIES
+        // ========================================================================
+
+        // Outgoing edges of entity
+        EdgeRange getFrom(EntityID entity) const {
+            const Node* n = node(entity);
+            return n ? EdgeRange(edges_.data(), n->firstOut, n->outCount, EdgeList::Out) : emptyRange(EdgeList::Out);
         }
 
-        // Get relationships to entity
-        const std::vector<Relationship>& getTo(EntityID entity) const {
-            static std::vector<Relationship> empty;
-            auto it = toIndex_.find(entity);
-            return (it != toIndex_.end()) ? it->second : empty;
+        // Incoming edges of entity
+        EdgeRange getTo(EntityID entity) const {
+            const Node* n = node(entity);
+            return n ? EdgeRange(edges_.data(), n->firstIn, n->inCount, EdgeList::In) : emptyRange(EdgeList::In);
         }
 
-        // Get relationships by type
-        const std::vector<Relationship>& getByType(RelationType type) const {
-            static std::vector<Relationship> empty;
-            auto it = typeIndex_.find(type);
-            return (it != typeIndex_.end()) ? it->second : empty;
+        // Edges of one type
+        EdgeRange getByType(RelationType type) const {
+            const TypeList& list = types_[static_cast<size_t>(type)];
+            return EdgeRange(edges_.data(), list.first, list.count, EdgeList::Type);
         }
 
         // Check if relationship exists
         bool exists(EntityID from, EntityID to, RelationType type) const {
-            Relationship rel;
-            rel.type = type;
-            rel.from = from;
-            rel.to = to;
-            return relationships_.find(rel) != relationships_.end();
+            return find(from, to, type) != INVALID_EDGE;
         }
 
-        // ========================================================================
-        // HIERARCHY TRAVERSAL
-        // ========================================================================
-
-        // Traverse hierarchy depth-first
-        template<typename Func>
-        void traverseDepthFirst(EntityID root, Func&& func, int depth = 0) const {
-            func(root, depth);
-            for (EntityID child : getChildren(root)) {
-                traverseDepthFirst(child, func, depth + 1);
-            }
+        // Bumped whenever an edge of this type is added, removed or
+        // reordered, so derived structures know when to rebuild
+        uint64_t getVersion(RelationType type) const {
+            return types_[static_cast<size_t>(type)].version;
         }
 
-        // Get all descendants
-        std::vector<EntityID> getDescendants(EntityID ancestor) const {
-            std::vector<EntityID> result;
-            traverseDepthFirst(ancestor, [&result, ancestor](EntityID id, int) {
-                if (id != ancestor) result.push_back(id);
-                });
-            return result;
-        }
+        // Clear all relationships
+        void clear();
 
-        // Get all ancestors (path to root)
-        std::vector<EntityID> getAncestors(EntityID entity) const {
-            std::vector<EntityID> ancestors;
-            EntityID current = getParent(entity);
-            while (current != INVALID_ENTITY) {
-                ancestors.push_back(current);
-                current = getParent(current);
-            }
-            return ancestors;
-        }
+        size_t size() const { return edgeCount_; }
 
-        // Check if 'ancestor' is ancestor of 'descendant'
-        bool isAncestorOf(EntityID ancestor, EntityID descendant) const {
-            EntityID current = getParent(descendant);
-            while (current != INVALID_ENTITY) {
-                if (current == ancestor) return true;
-                current = getParent(current);
-            }
-            return false;
+        // Edge table, weights, per-entity list heads and labels
+        MemoryUsage getMemoryUsage() const;
+
+        // Drop free slots at the end of the edge table and unused trailing
+        // entity slots. Interior free slots stay so live EdgeIDs don't move.
+        void shrinkToFit();
+
+    private:
+        // List heads for one entity index
+        struct Node {
+            EntityID id = INVALID_ENTITY;       // Owner of the lists below
+            EdgeID firstOut = INVALID_EDGE;
+            EdgeID lastOut = INVALID_EDGE;
+            EdgeID firstIn = INVALID_EDGE;
+            EdgeID lastIn = INVALID_EDGE;
+            uint32_t outCount = 0;
+            uint32_t inCount = 0;
+
+            bool empty() const { return outCount == 0 && inCount == 0; }
+        };
+
+        struct TypeList {
+            EdgeID first = INVALID_EDGE;
+            EdgeID last = INVALID_EDGE;
+            uint32_t count = 0;
+            uint64_t version = 0;
+        };
+
+        const Node* node(EntityID entity) const {
+            uint32_t index = getEntityIndex(entity);
+            if (index >= nodes_.size() || nodes_[index].id != entity) return nullptr;
+            return &nodes_[index];
         }
 
-        // Clear all relationships
-        void clear() {
-            relationships_.clear();
-            fromIndex_.clear();
-            toIndex_.clear();
-            typeIndex_.clear();
+        Node* node(EntityID entity) {
+            return const_cast<Node*>(static_cast<const RelationshipStore*>(this)->node(entity));
         }
 
-        size_t size() const { return relationships_.size(); }
+        // Node for 'entity', claiming its index slot if unused
+        Node& touchNode(EntityID entity);
 
-    private:
-        void removeFromVector(std::vector<Relationship>& vec, const Relationship& rel) {
-            vec.erase(
-                std::remove(vec.begin(), vec.end(), rel),
-                vec.end()
-            );
+        EdgeRange emptyRange(EdgeList list) const {
+            return EdgeRange(edges_.data(), INVALID_EDGE, 0, list);
         }
 
-        std::unordered_set<Relationship, RelationshipHash> relationships_;
-        std::unordered_map<EntityID, std::vector<Relationship>> fromIndex_;
-        std::unordered_map<EntityID, std::vector<Relationship>> toIndex_;
-        std::unordered_map<RelationType, std::vector<Relationship>> typeIndex_;
+        EdgeID allocateEdge();
+
+        std::vector<Edge> edges_;
+        std::vector<float> weights_;                    // Parallel to edges_
+        std::unordered_map<EdgeID, std::string> labels_;
+        std::vector<Node> nodes_;                       // By entity index
+        std::array<TypeList, TYPE_COUNT> types_{};
+        EdgeID freeHead_ = INVALID_EDGE;                // Threaded through nextOut
+        size_t edgeCount_ = 0;
     };
 
-} // namespace libre
\ No newline at end of file
+} // namespace libre
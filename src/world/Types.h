@@ -1,8 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 namespace libre {
 
@@ -68,6 +72,8 @@ namespace libre {
     // ============================================================================
     // ENTITY METADATA
     // ============================================================================
+    // Value snapshot. World keeps metadata as parallel arrays (MetadataStore);
+    // this struct is what World::getMetadata/setMetadata copy in and out.
 
     struct EntityMetadata {
         std::string name;
@@ -93,16 +99,174 @@ namespace libre {
         Constraint,         // Constraints (IK, etc.)
     };
 
+    constexpr size_t RELATION_TYPE_COUNT = static_cast<size_t>(RelationType::Constraint) + 1;
+
     // ============================================================================
     // COMPONENT TYPE IDS
     // ============================================================================
+    // Dense IDs handed out on first use (0, 1, 2, ...), so per-type tables can
+    // be plain vectors indexed by ID. IDs are stable for the process lifetime
+    // but depend on registration order; don't serialize them.
+
+    using ComponentTypeID = uint32_t;
 
-    using ComponentTypeID = size_t;
+    namespace detail {
+        inline std::atomic<ComponentTypeID>& componentTypeCounter() {
+            static std::atomic<ComponentTypeID> next{ 0 };
+            return next;
+        }
+    }
 
     template<typename T>
     ComponentTypeID getComponentTypeID() {
-        static ComponentTypeID id = typeid(T).hash_code();
+        static const ComponentTypeID id =
+            detail::componentTypeCounter().fetch_add(1, std::memory_order_relaxed);
         return id;
     }
 
+    // Number of IDs handed out so far
+    inline ComponentTypeID getComponentTypeCount() {
+        return detail::componentTypeCounter().load(std::memory_order_relaxed);
+    }
+
+    // ============================================================================
+    // COMPONENT STORAGE POLICY
+    // ============================================================================
+    // Per-type choice of sparse-set storage layout (ignored in Archetype mode).
+    //
+    // Dense (default): one contiguous array, removal swaps the last element
+    // into the hole. Fastest iteration, but any add may reallocate and any
+    // remove may move another component, so T* must not be kept.
+    //
+    // Paged: fixed-size pages that are never reallocated, and removal leaves
+    // a hole that the next add reuses. A T* stays valid until that entity's
+    // component is removed. Iteration walks the pages and skips holes.
+    //
+    //     template<> struct ComponentStorageTraits<MeshComponent> : PagedStorage<64> {};
+
+    struct DenseStorage {
+        static constexpr bool pointerStable = false;
+        static constexpr size_t pageSize = 0;
+    };
+
+    template<size_t PageSize = 1024>
+    struct PagedStorage {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "Page size must be a power of two");
+        static constexpr bool pointerStable = true;
+        static constexpr size_t pageSize = PageSize;
+    };
+
+    template<typename T>
+    struct ComponentStorageTraits : DenseStorage {};
+
+    // ============================================================================
+    // MEMORY USAGE - Bytes holding live data vs bytes allocated
+    // ============================================================================
+    // Estimates for the memory report. Allocator headers and alignment
+    // padding are not counted; node-based hash containers are charged one
+    // node per element plus the bucket array.
+
+    struct MemoryUsage {
+        size_t used = 0;        // Bytes holding live data
+        size_t reserved = 0;    // Bytes allocated (>= used)
+
+        size_t slack() const { return reserved - used; }
+
+        MemoryUsage& operator+=(const MemoryUsage& other) {
+            used += other.used;
+            reserved += other.reserved;
+            return *this;
+        }
+    };
+
+    // Per component type, split by what the bytes are for
+    struct ComponentMemory {
+        MemoryUsage components;     // The component values themselves
+        MemoryUsage owned;          // Heap owned by components (getHeapMemory())
+        MemoryUsage index;          // Entity index, ticks, change logs
+
+        MemoryUsage total() const {
+            MemoryUsage sum = components;
+            sum += owned;
+            sum += index;
+            return sum;
+        }
+
+        ComponentMemory& operator+=(const ComponentMemory& other) {
+            components += other.components;
+            owned += other.owned;
+            index += other.index;
+            return *this;
+        }
+    };
+
+    template<typename Vector>
+    MemoryUsage vectorMemory(const Vector& vector) {
+        using Value = typename Vector::value_type;
+        return { vector.size() * sizeof(Value), vector.capacity() * sizeof(Value) };
+    }
+
+    template<typename HashContainer>
+    MemoryUsage hashMemory(const HashContainer& container) {
+        using Value = typename HashContainer::value_type;
+        size_t nodes = container.size() * (sizeof(void*) + sizeof(size_t) + sizeof(Value));
+        return { nodes + container.size() * sizeof(void*), nodes + container.bucket_count() * sizeof(void*) };
+    }
+
+    // Heap block of a string (nothing while it fits the inline buffer)
+    inline MemoryUsage stringMemory(const std::string& str) {
+        static const size_t inlineCapacity = std::string().capacity();
+        if (str.capacity() <= inlineCapacity) return {};
+        return { str.size() + 1, str.capacity() + 1 };
+    }
+
+    // Components that own heap data (mesh buffers) report it by defining
+    // 'MemoryUsage getHeapMemory() const'; others own nothing extra.
+    namespace detail {
+        template<typename T, typename = void>
+        struct HasHeapMemory : std::false_type {};
+
+        template<typename T>
+        struct HasHeapMemory<T, std::void_t<decltype(std::declval<const T&>().getHeapMemory())>> : std::true_type {};
+    }
+
+    template<typename T>
+    MemoryUsage componentHeapMemory(const T& component) {
+        if constexpr (detail::HasHeapMemory<T>::value) {
+            return component.getHeapMemory();
+        }
+        else {
+            (void)component;
+            return {};
+        }
+    }
+
+    // ============================================================================
+    // CONTAINER HELPERS
+    // ============================================================================
+
+    // Reserve room for 'extra' more elements. Grows at least geometrically, so
+    // repeated bulk inserts don't reallocate on every call.
+    template<typename Vector>
+    void reserveMore(Vector& vector, size_t extra) {
+        size_t needed = vector.size() + extra;
+        if (needed > vector.capacity()) {
+            vector.reserve(needed > vector.capacity() * 2 ? needed : vector.capacity() * 2);
+        }
+    }
+
+    namespace detail {
+        // target = T(args...), except that a single T argument is assigned
+        // directly (copy-assignment can reuse the target's buffers)
+        template<typename T, typename... Args>
+        void assignComponent(T& target, Args&&... args) {
+            if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, T> && ...)) {
+                ((target = std::forward<Args>(args)), ...);
+            }
+            else {
+                target = T(std::forward<Args>(args)...);
+            }
+        }
+    }
+
 } // namespace libre
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Types.h"
+#include "ComponentStorage.h"
+#include <tuple>
+#include <array>
+#include <utility>
+#include <algorithm>
+
+namespace libre {
+
+    // ============================================================================
+    // EXCLUDE FILTER - world.view<A, B>(exclude<C>)
+    // ============================================================================
+
+    template<typename... Ts>
+    struct ExcludeList {};
+
+    template<typename... Ts>
+    inline constexpr ExcludeList<Ts...> exclude{};
+
+    template<typename Exclude, typename... Includes>
+    class View;
+
+    // ============================================================================
+    // VIEW - Iterate entities that have every included component
+    // ============================================================================
+    // Iteration is driven by the smallest included storage. Every other storage
+    // is probed through its sparse index, and the dense slots found there are
+    // handed to the callback directly, so there is no per-component hash lookup.
+
+    template<typename... Excludes, typename... Includes>
+    class View<ExcludeList<Excludes...>, Includes...> {
+        static_assert(sizeof...(Includes) > 0, "View needs at least one component");
+
+    public:
+        using Storages = std::tuple<ComponentStorage<Includes>*...>;
+        using ExcludeStorages = std::tuple<const ComponentStorage<Excludes>*...>;
+
+        View() = default;
+        View(Storages storages, ExcludeStorages excludes)
+            : storages_(storages), excludes_(excludes) {
+        }
+
+        // False if any included component type has never been registered
+        bool isValid() const {
+            return std::apply([](auto*... s) { return ((s != nullptr) && ...); }, storages_);
+        }
+
+        // Upper bound on the number of matching entities
+        size_t sizeHint() const {
+            if (!isValid()) return 0;
+            return std::get<0>(pickPivot(std::index_sequence_for<Includes...>{}));
+        }
+
+        // Iterate matching entities: func(EntityID, Includes&...)
+        template<typename Func>
+        void each(Func&& func) const {
+            eachInRange(0, sizeHint(), func);
+        }
+
+        // Iterate the pivot storage's dense slots [begin, end) only, where
+        // end <= sizeHint(). Disjoint ranges can run on different threads as
+        // long as no component is added or removed meanwhile.
+        template<typename Func>
+        void eachInRange(size_t begin, size_t end, Func&& func) const {
+            if (!isValid()) return;
+
+            auto [count, pivot, entities] = pickPivot(std::index_sequence_for<Includes...>{});
+            end = std::min(end, count);
+            for (size_t i = begin; i < end; ++i) {
+                EntityID entity = entities[i];
+                if (entity == INVALID_ENTITY) continue;     // Hole in a paged storage
+
+                std::array<uint32_t, sizeof...(Includes)> slots;
+
+                if (!resolve(entity, static_cast<uint32_t>(i), pivot, slots,
+                    std::index_sequence_for<Includes...>{})) {
+                    continue;
+                }
+                if (isExcluded(entity)) continue;
+
+                invoke(func, entity, slots, std::index_sequence_for<Includes...>{});
+            }
+        }
+
+        // Test a single entity against the view's filter
+        bool contains(EntityID entity) const {
+            if (!isValid()) return false;
+            bool all = std::apply([entity](auto*... s) { return (s->has(entity) && ...); }, storages_);
+            return all && !isExcluded(entity);
+        }
+
+    private:
+        template<size_t... I>
+        std::tuple<size_t, size_t, const EntityID*> pickPivot(std::index_sequence<I...>) const {
+            size_t best = static_cast<size_t>(-1);
+            size_t pivot = 0;
+            const EntityID* entities = nullptr;
+
+            ((std::get<I>(storages_)->denseSize() < best
+                ? (best = std::get<I>(storages_)->denseSize(), pivot = I,
+                    entities = std::get<I>(storages_)->entityData(), 0)
+                : 0), ...);
+
+            return { best, pivot, entities };
+        }
+
+        template<size_t... I>
+        bool resolve(EntityID entity, uint32_t pivotSlot, size_t pivot,
+            std::array<uint32_t, sizeof...(Includes)>& slots, std::index_sequence<I...>) const {
+            return ((slots[I] = (I == pivot) ? pivotSlot : std::get<I>(storages_)->indexOf(entity),
+                slots[I] != EntitySparseSet::NPOS) && ...);
+        }
+
+        bool isExcluded(EntityID entity) const {
+            return std::apply([entity](auto*... s) {
+                return ((s != nullptr && s->has(entity)) || ... || false);
+                }, excludes_);
+        }
+
+        template<typename Func, size_t... I>
+        void invoke(Func& func, EntityID entity,
+            const std::array<uint32_t, sizeof...(Includes)>& slots, std::index_sequence<I...>) const {
+            func(entity, std::get<I>(storages_)->getByIndex(slots[I])...);
+        }
+
+        Storages storages_{};
+        ExcludeStorages excludes_{};
+    };
+
+} // namespace libre
@@ -1,6 +1,13 @@
 #include "World.h"
 #include <iostream>
+#include <iomanip>
+#include <sstream>
 #include <algorithm>
+#include <cstdlib>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
 
 namespace libre {
 
@@ -12,12 +19,17 @@ namespace libre {
         return world_ && id_ != INVALID_ENTITY && world_->entityExists(id_);
     }
 
-    EntityMetadata* EntityHandle::getMetadata() {
-        return world_ ? world_->getMetadata(id_) : nullptr;
+    const std::string& EntityHandle::getName() const {
+        static const std::string empty;
+        return world_ ? world_->getName(id_) : empty;
+    }
+
+    void EntityHandle::setName(const std::string& name) {
+        if (world_) world_->setName(id_, name);
     }
 
-    const EntityMetadata* EntityHandle::getMetadata() const {
-        return world_ ? world_->getMetadata(id_) : nullptr;
+    std::optional<EntityMetadata> EntityHandle::getMetadata() const {
+        return world_ ? world_->getMetadata(id_) : std::nullopt;
     }
 
     EntityHandle EntityHandle::getParent() const {
@@ -41,11 +53,105 @@ namespace libre {
         }
     }
 
+    // ============================================================================
+    // ENTITY PROTOTYPE
+    // ============================================================================
+
+    EntityPrototype::EntityPrototype(std::string name, std::string type)
+        : name_(std::move(name)), type_(std::move(type)) {
+        with<TransformComponent>();
+    }
+
+    // ============================================================================
+    // MEMORY REPORT
+    // ============================================================================
+
+    namespace {
+
+        // typeid names: demangled on GCC/Clang, "struct " prefix dropped on MSVC
+        std::string readableTypeName(const char* name) {
+            std::string result = name ? name : "?";
+#if defined(__GNUG__)
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(result.c_str(), nullptr, nullptr, &status);
+            if (status == 0 && demangled) result = demangled;
+            std::free(demangled);
+#endif
+            for (const char* prefix : { "struct ", "class " }) {
+                if (result.rfind(prefix, 0) == 0) result.erase(0, std::char_traits<char>::length(prefix));
+            }
+            if (result.rfind("libre::", 0) == 0) result.erase(0, 7);
+            return result;
+        }
+
+        std::string formatBytes(size_t bytes) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1);
+            if (bytes >= 1024 * 1024) out << bytes / (1024.0 * 1024.0) << " MB";
+            else if (bytes >= 1024) out << bytes / 1024.0 << " KB";
+            else out << bytes << " B";
+            return out.str();
+        }
+
+        void writeRow(std::ostringstream& out, const std::string& name, const MemoryUsage& usage) {
+            out << "  " << std::left << std::setw(24) << name << std::right
+                << " used " << std::setw(10) << formatBytes(usage.used)
+                << "  reserved " << std::setw(10) << formatBytes(usage.reserved)
+                << "  slack " << std::setw(10) << formatBytes(usage.slack());
+        }
+
+    } // namespace
+
+    MemoryUsage MemoryReport::total() const {
+        MemoryUsage sum = archetypes;
+        sum += metadata;
+        sum += relationships;
+        sum += hierarchy;
+        sum += entities;
+        for (const auto& entry : components) {
+            sum += entry.memory.total();
+        }
+        return sum;
+    }
+
+    std::string MemoryReport::toString() const {
+        MemoryUsage all = total();
+
+        std::ostringstream out;
+        out << "=== Memory (used " << formatBytes(all.used) << ", reserved "
+            << formatBytes(all.reserved) << ", slack " << formatBytes(all.slack()) << ") ===\n";
+
+        for (const auto& entry : components) {
+            writeRow(out, entry.name, entry.memory.total());
+            out << "  x" << entry.count;
+            if (entry.memory.owned.reserved > 0) {
+                out << "  (heap " << formatBytes(entry.memory.owned.reserved) << ")";
+            }
+            out << "\n";
+        }
+        if (archetypes.reserved > 0) {
+            writeRow(out, "[archetypes]", archetypes);
+            out << "\n";
+        }
+        writeRow(out, "[metadata]", metadata);
+        out << "\n";
+        writeRow(out, "[relationships]", relationships);
+        out << "\n";
+        writeRow(out, "[hierarchy]", hierarchy);
+        out << "\n";
+        writeRow(out, "[entities]", entities);
+        out << "\n";
+        return out.str();
+    }
+
     // ============================================================================
     // WORLD IMPLEMENTATION
     // ============================================================================
 
-    World::World() {
+    World::World(StorageMode mode) : storageMode_(mode) {
+        if (storageMode_ == StorageMode::Archetype) {
+            archetypes_ = std::make_unique<ArchetypeStorage>();
+        }
         std::cout << "[World] Created" << std::endl;
     }
 
@@ -58,22 +164,12 @@ namespace libre {
     // ENTITY MANAGEMENT
     // ========================================================================
 
-    EntityID World::generateEntityID() {
-        uint32_t index = nextIndex_++;
-        uint32_t generation = generations_[index]++;
-        return makeEntityID(index, generation);
-    }
-
     EntityHandle World::createEntity(const std::string& name, const std::string& type) {
-        EntityID id = generateEntityID();
-        entities_.insert(id);
+        EntityID id = allocator_.create();
 
-        // Create metadata
-        EntityMetadata meta;
-        meta.name = name;
-        meta.type = type;
-        meta.flags = EntityFlags::Default;
-        entityMetadata_[id] = meta;
+        // Create metadata (type is interned, name is indexed)
+        metadata_.create(id, name, type);
+        hierarchy_.insert(id);
 
         // Always add TransformComponent
         addComponent<TransformComponent>(id);
@@ -81,33 +177,130 @@ namespace libre {
         return EntityHandle(this, id);
     }
 
+    std::vector<EntityID> World::createEntities(size_t count, const EntityPrototype& prototype) {
+        std::vector<EntityID> ids(count);
+        if (count == 0) return ids;
+
+        allocator_.create(count, ids.data());
+        metadata_.create(ids.data(), count, prototype.getName(), prototype.getType());
+        hierarchy_.insert(ids.data(), count);
+
+        if (archetypes_) {
+            // Straight into the final archetype, no per-component moves
+            std::vector<const ComponentTypeInfo*> types;
+            std::vector<const void*> values;
+            for (const auto& entry : prototype.components_) {
+                types.push_back(entry.info);
+                values.push_back(entry.value.get());
+            }
+            archetypes_->spawn(ids.data(), count, types, values);
+            for (const auto* info : types) {
+                if (observers_.wants(info->id)) {
+                    observers_.record(info->id, ObserverEvent::Add, ids.data(), count);
+                }
+            }
+            return ids;
+        }
+
+        for (const auto& entry : prototype.components_) {
+            entry.addTo(*this, ids.data(), count, entry.value.get());
+        }
+        return ids;
+    }
+
     void World::destroyEntity(EntityID id) {
-        if (!entityExists(id)) return;
+        destroyEntities(&id, 1);
+    }
+
+    void World::destroyEntities(const EntityID* entities, size_t count) {
+        std::vector<EntityID> doomed;
+        doomed.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (entityExists(entities[i])) doomed.push_back(entities[i]);
+        }
+        if (doomed.empty()) return;
+
+        std::sort(doomed.begin(), doomed.end());
+        doomed.erase(std::unique(doomed.begin(), doomed.end()), doomed.end());
+
+        // Cascade to descendants. Children that were requested explicitly are
+        // already queued, so each subtree is walked once.
+        size_t requested = doomed.size();
+        for (size_t i = 0; i < doomed.size(); ++i) {
+            for (EntityID child : hierarchy_.children(doomed[i])) {
+                if (std::binary_search(doomed.begin(), doomed.begin() + requested, child)) continue;
+                doomed.push_back(child);
+            }
+        }
+        std::sort(doomed.begin(), doomed.end());
+        doomed.erase(std::unique(doomed.begin(), doomed.end()), doomed.end());
+
+        EntityID lowest = doomed.front();
+        EntityID highest = doomed.back();
+        auto isDoomed = [&](EntityID id) {
+            if (id < lowest || id > highest) return false;
+            return std::binary_search(doomed.begin(), doomed.end(), id);
+        };
+
+        // Selection: a few IDs are erased one by one, large batches in one pass
+        if (doomed.size() <= 16) {
+            for (EntityID id : doomed) deselect(id);
+        }
+        else {
+            selection_.erase(std::remove_if(selection_.begin(), selection_.end(), isDoomed), selection_.end());
+            if (isDoomed(activeEntity_)) {
+                activeEntity_ = selection_.empty() ? INVALID_ENTITY : selection_.back();
+            }
+        }
+
+        relationships_.removeEntities(doomed);
+        hierarchy_.erase(doomed.data(), doomed.size());
 
-        // Remove from selection
-        deselect(id);
+        // Observers record what is about to go
+        observers_.recordRemovals(doomed.data(), doomed.size(), [this](EntityID id, ComponentTypeID type) {
+            return hasComponentType(id, type);
+            });
 
-        // Remove all children first (cascade delete)
-        auto children = getChildren(id);
-        for (EntityID childId : children) {
-            destroyEntity(childId);
+        // Components (sorted IDs also keep the sparse page accesses local)
+        for (auto& storage : componentStorages_) {
+            if (storage) storage->removeBulk(doomed.data(), doomed.size());
+        }
+        if (archetypes_) {
+            for (EntityID id : doomed) archetypes_->destroy(id);
         }
 
-        // Remove relationships
-        relationships_.removeEntity(id);
+        // Metadata and index recycling
+        for (EntityID id : doomed) {
+            metadata_.destroy(id);
+            allocator_.destroy(id);
+        }
+    }
 
-        // Remove all components
-        for (auto& [typeIndex, storage] : componentStorages_) {
-            storage->remove(id);
+    void World::destroyDeferred(EntityID id) {
+        std::lock_guard<std::mutex> lock(pendingDestroyMutex_);
+        pendingDestroy_.push_back(id);
+    }
+
+    size_t World::flushDestroyed() {
+        std::vector<EntityID> pending;
+        {
+            std::lock_guard<std::mutex> lock(pendingDestroyMutex_);
+            pending.swap(pendingDestroy_);
         }
+        if (pending.empty()) return 0;
+
+        size_t before = getEntityCount();
+        destroyEntities(pending);
+        return before - getEntityCount();
+    }
 
-        // Remove metadata and entity
-        entityMetadata_.erase(id);
-        entities_.erase(id);
+    size_t World::getPendingDestroyCount() const {
+        std::lock_guard<std::mutex> lock(pendingDestroyMutex_);
+        return pendingDestroy_.size();
     }
 
     bool World::entityExists(EntityID id) const {
-        return entities_.find(id) != entities_.end();
+        return allocator_.isAlive(id);
     }
 
     EntityHandle World::getEntity(EntityID id) {
@@ -119,21 +312,57 @@ namespace libre {
 
     std::vector<EntityHandle> World::getAllEntities() {
         std::vector<EntityHandle> result;
-        result.reserve(entities_.size());
-        for (EntityID id : entities_) {
+        result.reserve(allocator_.size());
+        for (EntityID id : allocator_.alive()) {
             result.emplace_back(this, id);
         }
         return result;
     }
 
-    EntityMetadata* World::getMetadata(EntityID id) {
-        auto it = entityMetadata_.find(id);
-        return (it != entityMetadata_.end()) ? &it->second : nullptr;
+    std::optional<EntityMetadata> World::getMetadata(EntityID id) const {
+        if (!metadata_.contains(id)) return std::nullopt;
+
+        EntityMetadata meta;
+        meta.name = metadata_.getName(id);
+        meta.type = metadata_.getType(id);
+        meta.flags = metadata_.getFlags(id);
+        meta.layer = metadata_.getLayer(id);
+        return meta;
     }
 
-    const EntityMetadata* World::getMetadata(EntityID id) const {
-        auto it = entityMetadata_.find(id);
-        return (it != entityMetadata_.end()) ? &it->second : nullptr;
+    void World::setMetadata(EntityID id, const EntityMetadata& meta) {
+        if (!metadata_.contains(id)) return;
+
+        metadata_.setName(id, meta.name);
+        metadata_.setType(id, meta.type);
+        metadata_.setFlags(id, meta.flags);
+        metadata_.setLayer(id, meta.layer);
+    }
+
+    // ========================================================================
+    // CHANGE DETECTION
+    // ========================================================================
+
+    void World::trimChangeLogs(uint32_t upTo) {
+        for (auto& storage : componentStorages_) {
+            if (storage) storage->trimChangeLog(upTo);
+        }
+    }
+
+    // ========================================================================
+    // OBSERVERS
+    // ========================================================================
+
+    size_t World::dispatchObservers() {
+        return observers_.dispatch([this](EntityID id, ComponentTypeID type) {
+            return hasComponentType(id, type);
+            });
+    }
+
+    bool World::hasComponentType(EntityID entity, ComponentTypeID type) const {
+        if (archetypes_) return archetypes_->hasType(entity, type);
+        if (type >= componentStorages_.size() || !componentStorages_[type]) return false;
+        return componentStorages_[type]->has(entity);
     }
 
     // ========================================================================
@@ -144,31 +373,29 @@ namespace libre {
         if (!entityExists(child)) return;
         if (parent != INVALID_ENTITY && !entityExists(parent)) return;
 
-        // Prevent circular relationships
-        if (parent != INVALID_ENTITY && relationships_.isAncestorOf(child, parent)) {
+        // Refuses cycles
+        if (!hierarchy_.setParent(child, parent)) {
             std::cerr << "[World] Cannot set parent: would create circular hierarchy" << std::endl;
             return;
         }
 
-        // Use RelationshipStore's setParent which handles removal of old parent
-        relationships_.setParent(child, parent);
-
-        // Mark transform as dirty
-        if (auto* transform = getComponent<TransformComponent>(child)) {
-            transform->dirty = true;
+        // World matrices depend on the parent. Without a transform of its
+        // own the child passes the change on to the nearest transforms below.
+        if (hasComponent<TransformComponent>(child)) {
+            markChanged<TransformComponent>(child);
+            return;
+        }
+        HierarchyWalker walk(hierarchy_);
+        for (EntityID id : walk.depthFirst(child, false)) {
+            if (!hasComponent<TransformComponent>(id)) continue;
+            markChanged<TransformComponent>(id);
+            walk.skipChildren();
         }
-    }
-
-    EntityID World::getParent(EntityID child) const {
-        return relationships_.getParent(child);
     }
 
     std::vector<EntityID> World::getChildren(EntityID parent) const {
-        return relationships_.getChildren(parent);
-    }
-
-    std::vector<EntityID> World::getRootEntities() const {
-        return relationships_.getRoots(entities_);
+        auto children = hierarchy_.children(parent);
+        return std::vector<EntityID>(children.begin(), children.end());
     }
 
     // ========================================================================
@@ -214,6 +441,86 @@ namespace libre {
         return std::find(selection_.begin(), selection_.end(), entity) != selection_.end();
     }
 
+    // ========================================================================
+    // MEMORY
+    // ========================================================================
+
+    MemoryReport World::memoryReport() const {
+        MemoryReport report;
+
+        for (ComponentTypeID type = 0; type < componentStorages_.size(); ++type) {
+            const auto& storage = componentStorages_[type];
+            if (!storage) continue;
+
+            MemoryReport::ComponentEntry entry;
+            entry.type = type;
+            entry.name = readableTypeName(storage->getTypeName());
+            entry.count = storage->size();
+            entry.memory = storage->getMemoryUsage();
+            report.components.push_back(std::move(entry));
+        }
+
+        if (archetypes_) {
+            std::vector<ComponentMemory> perType;
+            archetypes_->collectMemory(perType, report.archetypes);
+
+            std::vector<size_t> counts(perType.size(), 0);
+            std::vector<const char*> names(perType.size(), nullptr);
+            for (const auto& archetype : archetypes_->getArchetypes()) {
+                for (const auto* info : archetype->getTypeInfos()) {
+                    counts[info->id] += archetype->size();
+                    names[info->id] = info->name;
+                }
+            }
+
+            for (ComponentTypeID type = 0; type < perType.size(); ++type) {
+                if (!names[type]) continue;
+
+                MemoryReport::ComponentEntry entry;
+                entry.type = type;
+                entry.name = readableTypeName(names[type]);
+                entry.count = counts[type];
+                entry.memory = perType[type];
+                report.components.push_back(std::move(entry));
+            }
+        }
+
+        std::sort(report.components.begin(), report.components.end(),
+            [](const MemoryReport::ComponentEntry& a, const MemoryReport::ComponentEntry& b) {
+                return a.memory.total().reserved > b.memory.total().reserved;
+            });
+
+        report.metadata = metadata_.getMemoryUsage();
+        report.relationships = relationships_.getMemoryUsage();
+        report.hierarchy = hierarchy_.getMemoryUsage();
+
+        report.entities = allocator_.getMemoryUsage();
+        report.entities += vectorMemory(selection_);
+        {
+            std::lock_guard<std::mutex> lock(pendingDestroyMutex_);
+            report.entities += vectorMemory(pendingDestroy_);
+        }
+        return report;
+    }
+
+    void World::shrinkToFit() {
+        for (auto& storage : componentStorages_) {
+            if (storage) storage->shrinkToFit();
+        }
+        if (archetypes_) {
+            archetypes_->shrinkToFit();
+        }
+
+        metadata_.shrinkToFit();
+        relationships_.shrinkToFit();
+        hierarchy_.shrinkToFit();
+        allocator_.shrinkToFit();
+        selection_.shrink_to_fit();
+
+        std::lock_guard<std::mutex> lock(pendingDestroyMutex_);
+        pendingDestroy_.shrink_to_fit();
+    }
+
     // ========================================================================
     // UTILITY
     // ========================================================================
@@ -222,38 +529,46 @@ namespace libre {
         selection_.clear();
         activeEntity_ = INVALID_ENTITY;
 
+        {
+            std::lock_guard<std::mutex> lock(pendingDestroyMutex_);
+            pendingDestroy_.clear();
+        }
+
         relationships_.clear();
+        hierarchy_.clear();
+
+        // Every component goes; observers get it as one removal batch
+        const auto& alive = allocator_.alive();
+        observers_.recordRemovals(alive.data(), alive.size(), [this](EntityID id, ComponentTypeID type) {
+            return hasComponentType(id, type);
+            });
 
-        for (auto& [typeIndex, storage] : componentStorages_) {
-            storage->clear();
+        for (auto& storage : componentStorages_) {
+            if (storage) storage->clear();
+        }
+        if (archetypes_) {
+            archetypes_->clear();
         }
 
-        entityMetadata_.clear();
-        entities_.clear();
+        metadata_.clear();
 
-        // Reset ID generation but keep generations for safety
-        nextIndex_ = 1;
+        // Indices are recycled with bumped generations so old handles stay invalid
+        allocator_.clear();
     }
 
     std::vector<EntityHandle> World::findByName(const std::string& name) {
         std::vector<EntityHandle> result;
-        for (EntityID id : entities_) {
-            auto* meta = getMetadata(id);
-            if (meta && meta->name == name) {
-                result.emplace_back(this, id);
-            }
-        }
+        metadata_.forEachWithName(name, [&](EntityID id) {
+            result.emplace_back(this, id);
+            });
         return result;
     }
 
     std::vector<EntityHandle> World::findByType(const std::string& type) {
         std::vector<EntityHandle> result;
-        for (EntityID id : entities_) {
-            auto* meta = getMetadata(id);
-            if (meta && meta->type == type) {
-                result.emplace_back(this, id);
-            }
-        }
+        metadata_.forEachWithType(type, [&](EntityID id) {
+            result.emplace_back(this, id);
+            });
         return result;
     }
 
@@ -3,15 +3,22 @@
 #include "Types.h"
 #include "ComponentStorage.h"
 #include "RelationshipStore.h"
+#include "HierarchyStore.h"
+#include "View.h"
+#include "ArchetypeStorage.h"
+#include "EntityAllocator.h"
+#include "MetadataStore.h"
+#include "Observers.h"
 #include "../components/CoreComponents.h"
+#include "../core/ThreadPool.h"
 
-#include <unordered_map>
-#include <unordered_set>
 #include <memory>
-#include <typeindex>
 #include <vector>
 #include <string>
 #include <functional>
+#include <optional>
+#include <atomic>
+#include <mutex>
 
 namespace libre {
 
@@ -33,13 +40,18 @@ namespace libre {
         // Component access
         template<typename T> T* get();
         template<typename T> const T* get() const;
+        template<typename T> T* getMut();
         template<typename T> T& add(const T& component = T{});
+        template<typename T, typename = std::enable_if_t<!std::is_lvalue_reference_v<T>>>
+        T& add(T&& component);
+        template<typename T, typename... Args> T& emplace(Args&&... args);
         template<typename T> bool has() const;
         template<typename T> void remove();
 
         // Metadata
-        EntityMetadata* getMetadata();
-        const EntityMetadata* getMetadata() const;
+        const std::string& getName() const;
+        void setName(const std::string& name);
+        std::optional<EntityMetadata> getMetadata() const;
 
         // Hierarchy
         EntityHandle getParent() const;
@@ -56,32 +68,166 @@ namespace libre {
         EntityID id_;
     };
 
+    // ============================================================================
+    // ENTITY PROTOTYPE - Component set cloned by World::createEntities
+    // ============================================================================
+    // Holds one value per component type. Starts with a default
+    // TransformComponent because every entity gets one; with<T>() adds or
+    // replaces a component (pass an rvalue to move it in). Copies share the
+    // stored values.
+    //
+    //     EntityPrototype rock("Rock", "mesh");
+    //     rock.with(meshComp).with(RenderComponent{});
+    //     auto ids = world.createEntities(100000, rock);
+
+    class EntityPrototype {
+    public:
+        explicit EntityPrototype(std::string name = "Entity", std::string type = "");
+
+        template<typename T>
+        EntityPrototype& with(T component = T{});
+
+        template<typename T>
+        bool has() const {
+            return find(getComponentTypeID<T>()) != nullptr;
+        }
+
+        const std::string& getName() const { return name_; }
+        const std::string& getType() const { return type_; }
+        size_t getComponentCount() const { return components_.size(); }
+
+    private:
+        friend class World;
+
+        struct Entry {
+            const ComponentTypeInfo* info = nullptr;
+            std::shared_ptr<const void> value;
+            void (*addTo)(World& world, const EntityID* entities, size_t count, const void* value) = nullptr;
+        };
+
+        const Entry* find(ComponentTypeID type) const {
+            for (const auto& entry : components_) {
+                if (entry.info->id == type) return &entry;
+            }
+            return nullptr;
+        }
+
+        std::string name_;
+        std::string type_;
+        std::vector<Entry> components_;
+    };
+
+    // ============================================================================
+    // STORAGE MODE
+    // ============================================================================
+    // Sparse: one ComponentStorage per type (cheap structural changes, views).
+    // Archetype: entities with the same component set share 16 KiB chunks with
+    // one column per component, so co-iterated components stream linearly.
+    // In Archetype mode getStorage()/view() return empty results; use each().
+
+    enum class StorageMode : uint8_t {
+        Sparse,
+        Archetype
+    };
+
+    // ============================================================================
+    // MEMORY REPORT - Where a world's bytes go
+    // ============================================================================
+    // 'used' is what live data needs, 'reserved' what is allocated; the
+    // difference is slack that World::shrinkToFit() can partly give back.
+
+    struct MemoryReport {
+        struct ComponentEntry {
+            ComponentTypeID type = 0;
+            std::string name;
+            size_t count = 0;
+            ComponentMemory memory;
+        };
+
+        std::vector<ComponentEntry> components;     // Largest reservation first
+        MemoryUsage archetypes;     // Archetype mode: entity columns, padding, tables
+        MemoryUsage metadata;
+        MemoryUsage relationships;
+        MemoryUsage hierarchy;
+        MemoryUsage entities;       // ID allocator, selection, deferred destroys
+
+        MemoryUsage total() const;
+
+        // Human-readable table
+        std::string toString() const;
+    };
+
     // ============================================================================
     // WORLD - Central ECS container
     // ============================================================================
 
     class World {
     public:
-        World();
+        explicit World(StorageMode mode = StorageMode::Sparse);
         ~World();
 
+        StorageMode getStorageMode() const { return storageMode_; }
+
         // ========================================================================
         // ENTITY MANAGEMENT
         // ========================================================================
 
         EntityHandle createEntity(const std::string& name = "Entity",
             const std::string& type = "");
+        // Destroy an entity and its descendants
         void destroyEntity(EntityID id);
+
+        // Destroy many entities (and their descendants) in one batch: the
+        // hierarchy is expanded once, selection and relationships are filtered
+        // once, and every storage swap-removes its share in one pass. Dead or
+        // duplicate IDs are ignored.
+        void destroyEntities(const EntityID* entities, size_t count);
+        void destroyEntities(const std::vector<EntityID>& entities) {
+            destroyEntities(entities.data(), entities.size());
+        }
+
+        // Deferred destruction: queue now, destroy at the next
+        // flushDestroyed(). Safe to call from concurrently running systems;
+        // flush at a sync point. Returns the number of entities destroyed.
+        void destroyDeferred(EntityID id);
+        size_t flushDestroyed();
+        size_t getPendingDestroyCount() const;
+
         bool entityExists(EntityID id) const;
+
+        // Create 'count' entities with the prototype's name, type and
+        // components. Storages are grown once and each component type is
+        // copied in one pass. IDs are returned in creation order; freshly
+        // allocated indices are consecutive, recycled ones come first.
+        std::vector<EntityID> createEntities(size_t count, const EntityPrototype& prototype = EntityPrototype());
         EntityHandle getEntity(EntityID id);
 
         // Get all entities
         std::vector<EntityHandle> getAllEntities();
-        size_t getEntityCount() const { return entities_.size(); }
+        size_t getEntityCount() const { return allocator_.size(); }
+
+        // Dense list of live entity IDs (order changes when entities die)
+        const std::vector<EntityID>& getEntityIDs() const { return allocator_.alive(); }
+
+        // Entity metadata (stored as parallel arrays, see MetadataStore)
+        const std::string& getName(EntityID id) const { return metadata_.getName(id); }
+        const std::string& getType(EntityID id) const { return metadata_.getType(id); }
+        void setName(EntityID id, const std::string& name) { metadata_.setName(id, name); }
+        void setType(EntityID id, const std::string& type) { metadata_.setType(id, type); }
 
-        // Entity metadata
-        EntityMetadata* getMetadata(EntityID id);
-        const EntityMetadata* getMetadata(EntityID id) const;
+        EntityFlags getFlags(EntityID id) const { return metadata_.getFlags(id); }
+        void setFlags(EntityID id, EntityFlags flags) { metadata_.setFlags(id, flags); }
+        uint32_t getLayer(EntityID id) const { return metadata_.getLayer(id); }
+        void setLayer(EntityID id, uint32_t layer) { metadata_.setLayer(id, layer); }
+
+        bool isVisible(EntityID id) const { return hasFlag(getFlags(id), EntityFlags::Visible); }
+        bool isSelectable(EntityID id) const { return hasFlag(getFlags(id), EntityFlags::Selectable); }
+
+        // Snapshot of all metadata (copies strings; for undo and tooling)
+        std::optional<EntityMetadata> getMetadata(EntityID id) const;
+        void setMetadata(EntityID id, const EntityMetadata& meta);
+
+        const MetadataStore& getMetadataStore() const { return metadata_; }
 
         // ========================================================================
         // COMPONENT MANAGEMENT
@@ -89,30 +235,91 @@ namespace libre {
 
         template<typename T>
         T& addComponent(EntityID entity, const T& component = T{}) {
-            auto& storage = getOrCreateStorage<T>();
-            return storage.add(entity, component);
+            return emplaceComponent<T>(entity, component);
+        }
+
+        // Moves the component in; large payloads (mesh vertex/index buffers)
+        // change owner instead of being copied
+        template<typename T, typename = std::enable_if_t<!std::is_lvalue_reference_v<T>>>
+        T& addComponent(EntityID entity, T&& component) {
+            return emplaceComponent<T>(entity, std::move(component));
+        }
+
+        // Construct (or replace) the component in place from constructor args
+        template<typename T, typename... Args>
+        T& emplaceComponent(EntityID entity, Args&&... args) {
+            ComponentTypeID type = getComponentTypeID<T>();
+            if (observers_.wants(type) && !hasComponent<T>(entity)) {
+                observers_.record(type, ObserverEvent::Add, entity);
+            }
+
+            if (archetypes_) return archetypes_->emplace<T>(entity, std::forward<Args>(args)...);
+            return getOrCreateStorage<T>().emplace(entity, std::forward<Args>(args)...);
+        }
+
+        // Add (or replace) the same component on many entities
+        template<typename T>
+        void addComponents(const EntityID* entities, size_t count, const T& component = T{}) {
+            ComponentTypeID type = getComponentTypeID<T>();
+            if (observers_.wants(type)) {
+                for (size_t i = 0; i < count; ++i) {
+                    if (!hasComponent<T>(entities[i])) observers_.record(type, ObserverEvent::Add, entities[i]);
+                }
+            }
+
+            if (archetypes_) {
+                for (size_t i = 0; i < count; ++i) archetypes_->add<T>(entities[i], component);
+                return;
+            }
+            getOrCreateStorage<T>().addBulk(entities, count, component);
         }
 
         template<typename T>
         T* getComponent(EntityID entity) {
+            if (archetypes_) return archetypes_->get<T>(entity);
             auto* storage = getStorage<T>();
             return storage ? storage->get(entity) : nullptr;
         }
 
         template<typename T>
         const T* getComponent(EntityID entity) const {
+            if (archetypes_) return archetypes_->get<T>(entity);
             auto* storage = getStorage<T>();
             return storage ? storage->get(entity) : nullptr;
         }
 
+        // Get component for writing (marks it changed for changed<T>())
+        template<typename T>
+        T* getMut(EntityID entity) {
+            if (archetypes_) return archetypes_->get<T>(entity);
+            auto* storage = getStorage<T>();
+            return storage ? storage->getMut(entity) : nullptr;
+        }
+
+        template<typename T>
+        void markChanged(EntityID entity) {
+            if (archetypes_) return;
+            if (auto* storage = getStorage<T>()) storage->markChanged(entity);
+        }
+
         template<typename T>
         bool hasComponent(EntityID entity) const {
+            if (archetypes_) return archetypes_->has<T>(entity);
             auto* storage = getStorage<T>();
             return storage ? storage->has(entity) : false;
         }
 
         template<typename T>
         void removeComponent(EntityID entity) {
+            ComponentTypeID type = getComponentTypeID<T>();
+            if (observers_.wants(type) && hasComponent<T>(entity)) {
+                observers_.record(type, ObserverEvent::Remove, entity);
+            }
+
+            if (archetypes_) {
+                archetypes_->remove<T>(entity);
+                return;
+            }
             auto* storage = getStorage<T>();
             if (storage) storage->remove(entity);
         }
@@ -120,35 +327,193 @@ namespace libre {
         // Iterate over all entities with component
         template<typename T, typename Func>
         void forEach(Func&& func) {
+            if (archetypes_) {
+                archetypes_->each<T>(std::forward<Func>(func));
+                return;
+            }
             auto* storage = getStorage<T>();
             if (storage) {
                 storage->forEach(std::forward<Func>(func));
             }
         }
 
-        // Get component storage directly (for tight loops)
+        // Multi-component view: world.view<A, B>() or world.view<A, B>(exclude<C>)
+        template<typename... Ts, typename... Excludes>
+        View<ExcludeList<Excludes...>, Ts...> view(ExcludeList<Excludes...> = {}) {
+            return View<ExcludeList<Excludes...>, Ts...>(
+                std::make_tuple(getStorage<Ts>()...),
+                std::make_tuple(static_cast<const ComponentStorage<Excludes>*>(getStorage<Excludes>())...));
+        }
+
+        // Iterate entities having all components: func(EntityID, Ts&...)
+        template<typename... Ts, typename Func>
+        void each(Func&& func) {
+            if (archetypes_) {
+                archetypes_->each<Ts...>(std::forward<Func>(func));
+                return;
+            }
+            view<Ts...>().each(std::forward<Func>(func));
+        }
+
+        // ========================================================================
+        // CHANGE DETECTION
+        // ========================================================================
+        // addComponent/getMut/markChanged stamp components with the current
+        // change tick. A consumer closes the tick with advanceChangeTick(),
+        // queries everything newer than the tick it saw last time, then keeps
+        // the returned tick:
+        //
+        //     uint32_t now = world.advanceChangeTick();
+        //     world.changed<TransformComponent>(lastTick, ...);
+        //     lastTick = now;
+        //
+        // Archetype mode has no per-slot ticks: changed/added visit every
+        // component and removed visits nothing.
+        //
+        // Stamping isn't thread-safe: one thread at a time per component
+        // type (see PARALLEL ITERATION).
+
+        uint32_t getChangeTick() const { return changeTick_.load(std::memory_order_relaxed); }
+
+        // Start a new tick; returns the one that just closed. Safe to call
+        // while systems write other components.
+        uint32_t advanceChangeTick() { return changeTick_.fetch_add(1); }
+
+        // Components added or written after 'since': func(EntityID, T&)
+        template<typename T, typename Func>
+        void changed(uint32_t since, Func&& func) {
+            if (archetypes_) {
+                archetypes_->each<T>(std::forward<Func>(func));
+                return;
+            }
+            if (auto* storage = getStorage<T>()) storage->forEachChanged(since, std::forward<Func>(func));
+        }
+
+        // Components added after 'since': func(EntityID, T&)
+        template<typename T, typename Func>
+        void added(uint32_t since, Func&& func) {
+            if (archetypes_) {
+                archetypes_->each<T>(std::forward<Func>(func));
+                return;
+            }
+            if (auto* storage = getStorage<T>()) storage->forEachAdded(since, std::forward<Func>(func));
+        }
+
+        // Entities that lost T after 'since' (including destroyed ones): func(EntityID)
+        template<typename T, typename Func>
+        void removed(uint32_t since, Func&& func) const {
+            if (auto* storage = getStorage<T>()) storage->forEachRemoved(since, std::forward<Func>(func));
+        }
+
+        // Drop change records no consumer needs anymore (tick <= upTo).
+        // Call at a sync point: no system may be writing or querying.
+        void trimChangeLogs(uint32_t upTo);
+
+        // ========================================================================
+        // OBSERVERS
+        // ========================================================================
+        // Batched add/remove hooks (see ComponentObservers). Entities that
+        // gained or lost T are buffered and handed to func(const
+        // std::vector<EntityID>&) once per type at dispatchObservers(), sorted
+        // and without duplicates. Destroyed entities count as removals.
+        // Unobserved types cost one check per structural change.
+
+        template<typename T, typename Func>
+        ObserverID onAdd(Func&& func) {
+            return observers_.add(getComponentTypeID<T>(), ObserverEvent::Add, std::forward<Func>(func));
+        }
+
+        template<typename T, typename Func>
+        ObserverID onRemove(Func&& func) {
+            return observers_.add(getComponentTypeID<T>(), ObserverEvent::Remove, std::forward<Func>(func));
+        }
+
+        void removeObserver(ObserverID id) { observers_.remove(id); }
+
+        // Call at a sync point. Returns the number of batches delivered.
+        size_t dispatchObservers();
+
+        // ========================================================================
+        // PARALLEL ITERATION
+        // ========================================================================
+        // Same callbacks as forEach/each, but the dense range is split into
+        // grainSize-sized pieces that run on ThreadPool::instance(). func must
+        // be safe to call concurrently for different entities and must not add
+        // or remove components or entities.
+        //
+        // Writes through the component references are untracked. func must
+        // not call getMut or markChanged either: they append to the
+        // storage's change log, which isn't synchronized. Collect the
+        // written entities per range and mark them after the loop returns,
+        // the way TransformSystem::update stamps its bounds.
+
+        template<typename T, typename Func>
+        void parallelForEach(Func&& func, size_t grainSize = 1024) {
+            if (archetypes_) {
+                parallelEachArchetype<T>(func);
+                return;
+            }
+
+            auto* storage = getStorage<T>();
+            if (!storage) return;
+
+            const EntityID* entities = storage->entityData();
+            ThreadPool::instance().parallelFor(storage->denseSize(), grainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (entities[i] == INVALID_ENTITY) continue;
+                    func(entities[i], storage->getByIndex(i));
+                }
+                });
+        }
+
+        template<typename... Ts, typename Func>
+        void parallelEach(Func&& func, size_t grainSize = 1024) {
+            if (archetypes_) {
+                parallelEachArchetype<Ts...>(func);
+                return;
+            }
+
+            auto v = view<Ts...>();
+            ThreadPool::instance().parallelFor(v.sizeHint(), grainSize, [&](size_t begin, size_t end) {
+                v.eachInRange(begin, end, func);
+                });
+        }
+
+        // Get component storage directly (for tight loops). Indexed by
+        // getComponentTypeID<T>(), no hashing.
         template<typename T>
         ComponentStorage<T>* getStorage() {
-            auto it = componentStorages_.find(std::type_index(typeid(T)));
-            if (it == componentStorages_.end()) return nullptr;
-            return static_cast<ComponentStorage<T>*>(it->second.get());
+            ComponentTypeID type = getComponentTypeID<T>();
+            if (type >= componentStorages_.size()) return nullptr;
+            return static_cast<ComponentStorage<T>*>(componentStorages_[type].get());
         }
 
         template<typename T>
         const ComponentStorage<T>* getStorage() const {
-            auto it = componentStorages_.find(std::type_index(typeid(T)));
-            if (it == componentStorages_.end()) return nullptr;
-            return static_cast<const ComponentStorage<T>*>(it->second.get());
+            ComponentTypeID type = getComponentTypeID<T>();
+            if (type >= componentStorages_.size()) return nullptr;
+            return static_cast<const ComponentStorage<T>*>(componentStorages_[type].get());
         }
 
         // ========================================================================
         // RELATIONSHIPS / HIERARCHY
         // ========================================================================
 
+        // The scene hierarchy lives in a HierarchyStore; getRelationships()
+        // holds every other relation type.
+
         void setParent(EntityID child, EntityID parent);
-        EntityID getParent(EntityID child) const;
+        EntityID getParent(EntityID child) const { return hierarchy_.getParent(child); }
         std::vector<EntityID> getChildren(EntityID parent) const;
-        std::vector<EntityID> getRootEntities() const;
+        const std::vector<EntityID>& getRootEntities() const { return hierarchy_.getRoots(); }
+
+        // Allocation-free child iteration, depth, ancestry tests
+        const HierarchyStore& getHierarchy() const { return hierarchy_; }
+
+        // Rebuild the hierarchy's interval index after reparenting, so
+        // ancestry tests and subtree scans are O(1)/contiguous again. Call
+        // at a sync point; a no-op when nothing moved.
+        void updateHierarchyIndex() { hierarchy_.updateIntervals(); }
 
         RelationshipStore& getRelationships() { return relationships_; }
         const RelationshipStore& getRelationships() const { return relationships_; }
@@ -167,6 +532,18 @@ namespace libre {
         EntityID getActiveEntity() const { return activeEntity_; }
         void setActiveEntity(EntityID entity) { activeEntity_ = entity; }
 
+        // ========================================================================
+        // MEMORY
+        // ========================================================================
+
+        // Visits every component that owns heap data, so this is for debug
+        // output, not per-frame use
+        MemoryReport memoryReport() const;
+
+        // Release capacity left behind by large deletions. Pointer-stable
+        // components stay where they are.
+        void shrinkToFit();
+
         // ========================================================================
         // UTILITY
         // ========================================================================
@@ -180,40 +557,86 @@ namespace libre {
         std::vector<EntityHandle> findByType(const std::string& type);
 
     private:
+        // One chunk per task; chunks already hold hundreds of rows
+        template<typename... Ts, typename Func>
+        void parallelEachArchetype(Func& func) {
+            auto chunks = archetypes_->matchingChunks<Ts...>();
+            ThreadPool::instance().parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; ++c) {
+                    archetypes_->eachInChunk<Ts...>(chunks[c], func);
+                }
+                });
+        }
+
+        // Type-erased hasComponent, for observer bookkeeping
+        bool hasComponentType(EntityID entity, ComponentTypeID type) const;
+
         template<typename T>
         ComponentStorage<T>& getOrCreateStorage() {
-            auto key = std::type_index(typeid(T));
-            auto it = componentStorages_.find(key);
-            if (it == componentStorages_.end()) {
+            ComponentTypeID type = getComponentTypeID<T>();
+            if (type >= componentStorages_.size()) {
+                componentStorages_.resize(static_cast<size_t>(type) + 1);
+            }
+
+            auto& slot = componentStorages_[type];
+            if (!slot) {
                 auto storage = std::make_unique<ComponentStorage<T>>();
-                auto* ptr = storage.get();
-                componentStorages_[key] = std::move(storage);
-                return *ptr;
+                storage->bindChangeClock(&changeTick_);
+                slot = std::move(storage);
             }
-            return *static_cast<ComponentStorage<T>*>(it->second.get());
+            return *static_cast<ComponentStorage<T>*>(slot.get());
         }
 
         // Entity storage
-        std::unordered_set<EntityID> entities_;
-        std::unordered_map<EntityID, EntityMetadata> entityMetadata_;
+        EntityAllocator allocator_;
+        MetadataStore metadata_;
 
-        // Component storages
-        std::unordered_map<std::type_index, std::unique_ptr<IComponentStorage>> componentStorages_;
+        // Component storages by ComponentTypeID (null for types this world
+        // never stored)
+        std::vector<std::unique_ptr<IComponentStorage>> componentStorages_;
+        StorageMode storageMode_ = StorageMode::Sparse;
+        std::unique_ptr<ArchetypeStorage> archetypes_;   // Only in Archetype mode
+        std::atomic<uint32_t> changeTick_{ 1 };
 
-        // Relationships
+        // Relationships and scene hierarchy
         RelationshipStore relationships_;
+        HierarchyStore hierarchy_;
+
+        // onAdd/onRemove handlers and their pending batches
+        ComponentObservers observers_;
 
         // Selection
         std::vector<EntityID> selection_;
         EntityID activeEntity_ = INVALID_ENTITY;
 
-        // ID generation
-        uint32_t nextIndex_ = 1;
-        std::unordered_map<uint32_t, uint32_t> generations_;
-
-        EntityID generateEntityID();
+        // Deferred destruction queue
+        std::vector<EntityID> pendingDestroy_;
+        mutable std::mutex pendingDestroyMutex_;
     };
 
+    // ============================================================================
+    // ENTITY PROTOTYPE TEMPLATE IMPLEMENTATIONS
+    // ============================================================================
+
+    template<typename T>
+    EntityPrototype& EntityPrototype::with(T component) {
+        Entry entry;
+        entry.info = &ComponentTypeInfo::of<T>();
+        entry.value = std::make_shared<const T>(std::move(component));
+        entry.addTo = [](World& world, const EntityID* entities, size_t count, const void* value) {
+            world.addComponents<T>(entities, count, *static_cast<const T*>(value));
+        };
+
+        for (auto& existing : components_) {
+            if (existing.info == entry.info) {
+                existing = std::move(entry);
+                return *this;
+            }
+        }
+        components_.push_back(std::move(entry));
+        return *this;
+    }
+
     // ============================================================================
     // ENTITY HANDLE TEMPLATE IMPLEMENTATIONS
     // ============================================================================
@@ -228,11 +651,26 @@ namespace libre {
         return world_ ? world_->getComponent<T>(id_) : nullptr;
     }
 
+    template<typename T>
+    T* EntityHandle::getMut() {
+        return world_ ? world_->getMut<T>(id_) : nullptr;
+    }
+
     template<typename T>
     T& EntityHandle::add(const T& component) {
         return world_->addComponent<T>(id_, component);
     }
 
+    template<typename T, typename>
+    T& EntityHandle::add(T&& component) {
+        return world_->addComponent<T>(id_, std::move(component));
+    }
+
+    template<typename T, typename... Args>
+    T& EntityHandle::emplace(Args&&... args) {
+        return world_->emplaceComponent<T>(id_, std::forward<Args>(args)...);
+    }
+
     template<typename T>
     bool EntityHandle::has() const {
         return world_ ? world_->hasComponent<T>(id_) : false;
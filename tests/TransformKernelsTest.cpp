@@ -0,0 +1,253 @@
+// TransformKernels against glm references, at every SIMD level the CPU
+// supports. Returns non-zero if anything differs by more than float
+// rounding.
+
+#include "core/TransformKernels.h"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace libre;
+
+namespace {
+
+    int failures = 0;
+
+    // Float rounding relative to the largest element compared: a small
+    // result can still be the sum of large terms
+    bool near(float a, float b, float magnitude) {
+        return std::fabs(a - b) <= 1e-5f * std::max(1.0f, magnitude);
+    }
+
+    void fail(const char* what, SimdLevel level, size_t count, size_t index) {
+        if (++failures <= 20) {
+            std::printf("FAIL %s [%s] count=%zu index=%zu\n", what, TransformKernels::getLevelName(level), count, index);
+        }
+    }
+
+    float maxAbs(const glm::vec3& v) {
+        return std::max(std::fabs(v.x), std::max(std::fabs(v.y), std::fabs(v.z)));
+    }
+
+    float maxAbs(const Affine3x4& m) {
+        float result = 0.0f;
+        for (const auto& row : m.rows) result = std::max(result, std::max(maxAbs(glm::vec3(row)), std::fabs(row.w)));
+        return result;
+    }
+
+    bool sameMatrix(const Affine3x4& a, const Affine3x4& b) {
+        float magnitude = maxAbs(b);
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                if (!near(a.rows[r][c], b.rows[r][c], magnitude)) return false;
+            }
+        }
+        return true;
+    }
+
+    bool sameVector(const glm::vec3& a, const glm::vec3& b, float magnitude) {
+        return near(a.x, b.x, magnitude) && near(a.y, b.y, magnitude) && near(a.z, b.z, magnitude);
+    }
+
+    // Sentinel written past the end of every output, to catch remainder
+    // paths that write one batch too far
+    Affine3x4 guardMatrix() {
+        Affine3x4 guard;
+        for (auto& row : guard.rows) row = glm::vec4(12345.0f);
+        return guard;
+    }
+
+    const glm::vec3 GUARD_VECTOR(-12345.0f);
+
+    // ========================================================================
+    // INPUTS
+    // ========================================================================
+
+    struct TRSData {
+        std::vector<float> px, py, pz, qx, qy, qz, qw, sx, sy, sz;
+
+        explicit TRSData(size_t count, std::mt19937& rng) {
+            std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+            for (auto* v : { &px, &py, &pz, &qx, &qy, &qz, &qw, &sx, &sy, &sz }) v->resize(count);
+
+            for (size_t i = 0; i < count; ++i) {
+                px[i] = position(rng);
+                py[i] = position(rng);
+                pz[i] = position(rng);
+
+                glm::quat q(unit(rng), unit(rng), unit(rng), unit(rng));
+                q = glm::normalize(q);
+                qx[i] = q.x;
+                qy[i] = q.y;
+                qz[i] = q.z;
+                qw[i] = q.w;
+
+                // Non-uniform, and now and then mirrored
+                sx[i] = scale(rng) * (i % 7 == 3 ? -1.0f : 1.0f);
+                sy[i] = scale(rng);
+                sz[i] = scale(rng);
+            }
+        }
+
+        TRSArrays arrays() const {
+            return TRSArrays{ px.data(), py.data(), pz.data(), qx.data(), qy.data(), qz.data(), qw.data(),
+                sx.data(), sy.data(), sz.data() };
+        }
+
+        glm::mat4 reference(size_t i) const {
+            glm::quat q(qw[i], qx[i], qy[i], qz[i]);
+            return glm::translate(glm::mat4(1.0f), glm::vec3(px[i], py[i], pz[i]))
+                * glm::mat4_cast(q)
+                * glm::scale(glm::mat4(1.0f), glm::vec3(sx[i], sy[i], sz[i]));
+        }
+    };
+
+    enum class ParentMix {
+        NoArray,        // parents == nullptr
+        AllNull,        // every parents[i] null
+        AllSet,
+        Alternating,    // set on even i
+        Sparse,         // set on every third i
+    };
+
+    const char* getMixName(ParentMix mix) {
+        switch (mix) {
+        case ParentMix::NoArray: return "composeTRS, no parent array";
+        case ParentMix::AllNull: return "composeTRS, null parents";
+        case ParentMix::AllSet: return "composeTRS, all parents";
+        case ParentMix::Alternating: return "composeTRS, alternating parents";
+        case ParentMix::Sparse: return "composeTRS, every third parent";
+        }
+        return "composeTRS";
+    }
+
+    bool hasParent(ParentMix mix, size_t i) {
+        switch (mix) {
+        case ParentMix::AllSet: return true;
+        case ParentMix::Alternating: return i % 2 == 0;
+        case ParentMix::Sparse: return i % 3 == 0;
+        default: return false;
+        }
+    }
+
+    // ========================================================================
+    // TESTS
+    // ========================================================================
+
+    void testComposeTRS(SimdLevel level, size_t count, ParentMix mix, std::mt19937& rng) {
+        TRSData trs(count, rng);
+
+        TRSData parentTRS(count, rng);
+        std::vector<Affine3x4> parentMatrices(count);
+        std::vector<const Affine3x4*> parents(count, nullptr);
+        for (size_t i = 0; i < count; ++i) {
+            parentMatrices[i] = Affine3x4::fromMat4(parentTRS.reference(i));
+            if (hasParent(mix, i)) parents[i] = &parentMatrices[i];
+        }
+
+        std::vector<Affine3x4> out(count + 1, guardMatrix());
+        TransformKernels::composeTRS(trs.arrays(), mix == ParentMix::NoArray ? nullptr : parents.data(), count, out.data());
+
+        for (size_t i = 0; i < count; ++i) {
+            glm::mat4 expected = trs.reference(i);
+            if (parents[i]) expected = parents[i]->toMat4() * expected;
+
+            if (!sameMatrix(out[i], Affine3x4::fromMat4(expected))) fail(getMixName(mix), level, count, i);
+        }
+        if (!sameMatrix(out[count], guardMatrix())) fail("composeTRS wrote past the end", level, count, count);
+    }
+
+    void testTransformAABBs(SimdLevel level, size_t count, std::mt19937& rng) {
+        TRSData trs(count, rng);
+        std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+
+        std::vector<Affine3x4> matrices(count);
+        std::vector<glm::vec3> localMin(count), localMax(count);
+        for (size_t i = 0; i < count; ++i) {
+            matrices[i] = Affine3x4::fromMat4(trs.reference(i));
+            glm::vec3 a(coord(rng), coord(rng), coord(rng));
+            glm::vec3 b(coord(rng), coord(rng), coord(rng));
+            localMin[i] = glm::min(a, b);
+            localMax[i] = glm::max(a, b);
+        }
+
+        std::vector<glm::vec3> worldMin(count + 1, GUARD_VECTOR), worldMax(count + 1, GUARD_VECTOR);
+        TransformKernels::transformAABBs(matrices.data(), localMin.data(), localMax.data(), count,
+            worldMin.data(), worldMax.data());
+
+        for (size_t i = 0; i < count; ++i) {
+            // Brute force: the box around all 8 transformed corners
+            glm::vec3 expectedMin(std::numeric_limits<float>::max());
+            glm::vec3 expectedMax(std::numeric_limits<float>::lowest());
+            for (int corner = 0; corner < 8; ++corner) {
+                glm::vec3 p(
+                    (corner & 1) ? localMax[i].x : localMin[i].x,
+                    (corner & 2) ? localMax[i].y : localMin[i].y,
+                    (corner & 4) ? localMax[i].z : localMin[i].z);
+                glm::vec3 w = glm::vec3(matrices[i].toMat4() * glm::vec4(p, 1.0f));
+                expectedMin = glm::min(expectedMin, w);
+                expectedMax = glm::max(expectedMax, w);
+            }
+
+            // Bound on every term summed into a corner coordinate
+            float magnitude = maxAbs(matrices[i]) * (1.0f + 3.0f * std::max(maxAbs(localMin[i]), maxAbs(localMax[i])));
+            if (!sameVector(worldMin[i], expectedMin, magnitude) || !sameVector(worldMax[i], expectedMax, magnitude)) {
+                fail("transformAABBs", level, count, i);
+            }
+        }
+        if (worldMin[count] != GUARD_VECTOR || worldMax[count] != GUARD_VECTOR) {
+            fail("transformAABBs wrote past the end", level, count, count);
+        }
+    }
+
+} // namespace
+
+int main() {
+    // Every remainder shape of the 4- and 8-wide loops, plus a few full batches
+    const size_t counts[] = { 1, 3, 4, 5, 8, 9, 15, 16, 17, 64, 1001 };
+    const ParentMix mixes[] = { ParentMix::NoArray, ParentMix::AllNull, ParentMix::AllSet,
+        ParentMix::Alternating, ParentMix::Sparse };
+
+    SimdLevel supported = TransformKernels::getSupportedLevel();
+    std::mt19937 rng(22);
+
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 }) {
+        if (level > supported) {
+            std::printf("skip %s (not supported by this CPU)\n", TransformKernels::getLevelName(level));
+            continue;
+        }
+
+        TransformKernels::setLevel(level);
+        if (TransformKernels::getLevel() != level) {
+            fail("setLevel", level, 0, 0);
+            continue;
+        }
+
+        int failuresBefore = failures;
+        for (size_t count : counts) {
+            for (ParentMix mix : mixes) testComposeTRS(level, count, mix, rng);
+            testTransformAABBs(level, count, rng);
+        }
+        std::printf("%s %s\n", failures == failuresBefore ? "ok  " : "FAIL", TransformKernels::getLevelName(level));
+    }
+
+    TransformKernels::setLevel(supported);
+
+    if (failures > 0) {
+        std::printf("%d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}